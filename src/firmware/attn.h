@@ -0,0 +1,178 @@
+/*
+ * Two-stage approximate attention for llama2.c
+ *
+ * Every cached key also gets an int4 shadow (one fixed-point scale per
+ * position and kv head, 8 values per word). For one head at position pos:
+ *   1. score positions [0, pos - window] against the shadow with an integer
+ *      dot product times the integer scale and keep the top k (int32 only,
+ *      no soft-float per position)
+ *   2. score those k plus the last window positions exactly (fp32 keys),
+ *      softmax over them only and accumulate their values
+ * Positions outside the selection get zero weight. Stage 1 reads one word
+ * per 8 key dims instead of 8, stage 2 is exact attention over k + window
+ * positions, so the cost stops growing with pos except for the shadow scan.
+ *
+ * Header-only so the same code runs in the firmware and in the host
+ * accuracy report (tools/attn_report.c). Needs expf() and sqrtf().
+ */
+
+#ifndef ATTN_H
+#define ATTN_H
+
+#include <stdint.h>
+
+#define ATTN_SHADOW_MAX     7       /* int4 range [-7, 7] */
+#define ATTN_QUERY_MAX      127     /* stage 1 query, int16 storage */
+
+/* Shadow scale: step between int4 levels in units of 2^-ATTN_SCALE_FRAC,
+ * at most ATTN_SCALE_LIMIT (keys up to |k| = 112). With head_size <= 128 a
+ * stage 1 score stays below 7 * 127 * 128 * 2^14 < 2^31. */
+#define ATTN_SCALE_FRAC     10
+#define ATTN_SCALE_LIMIT    ((1 << 14) - 1)
+
+/* One head's view of the caches: position t at t * stride (floats),
+ * t * kq_stride (words) and t * ks_stride (scales) */
+typedef struct {
+    const float*    k;
+    const float*    v;
+    int             stride;
+    const uint32_t* kq;
+    const uint32_t* ks;
+    int             kq_stride;
+    int             ks_stride;
+    int             head_size;
+} AttnHead;
+
+static inline int attn_shadow_words(int head_size) {
+    return (head_size + 7) >> 3;
+}
+
+static inline int32_t attn_round(float v) {
+    return v >= 0.0f ? (int32_t)(v + 0.5f) : (int32_t)(v - 0.5f);
+}
+
+/* int4 shadow of one head's key: attn_shadow_words() words and a scale.
+ * The values are quantized with the rounded (and limited) scale, so the
+ * integer score matches the shadow that is stored. */
+static void attn_shadow_key(uint32_t* kq, uint32_t* ks, const float* k, int head_size) {
+    float amax = 0.0f;
+    for (int i = 0; i < head_size; i++) {
+        float a = k[i] < 0.0f ? -k[i] : k[i];
+        if (a > amax) amax = a;
+    }
+    int32_t scale = attn_round(amax * (float)(1 << ATTN_SCALE_FRAC) / (float)ATTN_SHADOW_MAX);
+    if (scale > ATTN_SCALE_LIMIT) scale = ATTN_SCALE_LIMIT;
+    if (scale < 1 && amax > 0.0f) scale = 1;
+    float inv = scale > 0 ? (float)(1 << ATTN_SCALE_FRAC) / (float)scale : 0.0f;
+    *ks = (uint32_t)scale;
+    for (int w = 0; w < attn_shadow_words(head_size); w++) {
+        uint32_t word = 0;
+        for (int b = 0; b < 8; b++) {
+            int i = w * 8 + b;
+            int32_t v = i < head_size ? attn_round(k[i] * inv) : 0;
+            if (v > ATTN_SHADOW_MAX) v = ATTN_SHADOW_MAX;
+            if (v < -ATTN_SHADOW_MAX) v = -ATTN_SHADOW_MAX;
+            word |= (uint32_t)(v & 0xF) << (b * 4);
+        }
+        kq[w] = word;
+    }
+}
+
+/* Stage 1 query: q scaled to [-127, 127], zero padded to whole shadow words.
+ * Its scale is the same for every position, so it does not affect the ranking. */
+static void attn_query(int16_t* qq, const float* q, int head_size) {
+    float amax = 0.0f;
+    for (int i = 0; i < head_size; i++) {
+        float a = q[i] < 0.0f ? -q[i] : q[i];
+        if (a > amax) amax = a;
+    }
+    float inv = amax > 0.0f ? (float)ATTN_QUERY_MAX / amax : 0.0f;
+    for (int i = 0; i < head_size; i++) {
+        qq[i] = (int16_t)attn_round(q[i] * inv);
+    }
+    for (int i = head_size; i < attn_shadow_words(head_size) * 8; i++) {
+        qq[i] = 0;
+    }
+}
+
+/* Stage 1 score of position t (up to the query scale and 2^ATTN_SCALE_FRAC) */
+static inline int32_t attn_shadow_score(const AttnHead* a, const int16_t* qq, int t) {
+    const uint32_t* kq = a->kq + t * a->kq_stride;
+    int32_t acc = 0;
+    for (int w = 0; w < attn_shadow_words(a->head_size); w++) {
+        uint32_t word = kq[w];
+        for (int b = 0; b < 8; b++) {
+            acc += ((int32_t)(word << (28 - b * 4)) >> 28) * qq[w * 8 + b];
+        }
+    }
+    return acc * (int32_t)a->ks[t * a->ks_stride];
+}
+
+/*
+ * Approximate attention for one head: xb = sum over the selected positions
+ * of softmax(q.k / sqrt(head_size)) * v. sel and sel_score hold topk + window
+ * entries, att as many. Returns the number of positions scored exactly.
+ */
+static int attn_head_approx(float* xb, const float* q, const int16_t* qq, const AttnHead* a,
+                            int pos, int topk, int window, int* sel, int32_t* sel_score, float* att) {
+    int hs = a->head_size;
+    int recent = pos + 1 - window;     /* [recent, pos] always exact */
+    if (recent < 0) recent = 0;
+    int n = 0;
+
+    if (recent <= topk) {
+        recent = 0;                     /* nothing to skip: exact over [0, pos] */
+    } else {
+        /* Stage 1: running top k, replacing the current minimum */
+        int min_i = 0;
+        for (int t = 0; t < recent; t++) {
+            int32_t sc = attn_shadow_score(a, qq, t);
+            if (n < topk) {
+                sel[n] = t;
+                sel_score[n] = sc;
+                if (sc < sel_score[min_i]) min_i = n;
+                n++;
+            } else if (sc > sel_score[min_i]) {
+                sel[min_i] = t;
+                sel_score[min_i] = sc;
+                for (int i = 0; i < topk; i++) {
+                    if (sel_score[i] < sel_score[min_i]) min_i = i;
+                }
+            }
+        }
+    }
+    for (int t = recent; t <= pos; t++) {
+        sel[n++] = t;
+    }
+
+    /* Stage 2: exact scores, softmax and values over the selection */
+    float inv_sqrt = 1.0f / sqrtf(hs);
+    float max_val = -1e30f;
+    for (int i = 0; i < n; i++) {
+        const float* k = a->k + sel[i] * a->stride;
+        float score = 0.0f;
+        for (int j = 0; j < hs; j++) {
+            score += q[j] * k[j];
+        }
+        att[i] = score * inv_sqrt;
+        if (att[i] > max_val) max_val = att[i];
+    }
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        att[i] = expf(att[i] - max_val);
+        sum += att[i];
+    }
+    for (int j = 0; j < hs; j++) {
+        xb[j] = 0.0f;
+    }
+    for (int i = 0; i < n; i++) {
+        const float* v = a->v + sel[i] * a->stride;
+        float w = att[i] / sum;
+        for (int j = 0; j < hs; j++) {
+            xb[j] += w * v[j];
+        }
+    }
+    return n;
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * Cooperative coroutines for VexRiscv
+ * Round-robin scheduler over a fixed task table; the register switch is
+ * coro_switch.S
+ */
+
+#include "coro.h"
+#include "terminal.h"
+
+#define CORO_STACK_CANARY 0xC0DEC0DE
+
+enum { CORO_FREE, CORO_RUNNING, CORO_DONE };
+
+// Callee-saved registers, in coro_switch.S order: ra, sp, s0-s11
+typedef struct {
+    uint32_t ra;
+    uint32_t sp;
+    uint32_t s[12];
+} coro_ctx_t;
+
+typedef struct {
+    coro_ctx_t ctx;
+    int state;
+    uint32_t* canary;       // stack bottom, 0 for task 0
+} coro_task_t;
+
+extern void coro_switch(coro_ctx_t* from, const coro_ctx_t* to);
+extern void coro_entry(void);
+void coro_exit(void);
+
+// Task 0 is the start.S stack, always running
+static coro_task_t tasks[CORO_MAX_TASKS + 1] = { [0] = { .state = CORO_RUNNING } };
+static int current = 0;
+
+// Next running task after current, or current if there is none
+static int next_task(void) {
+    int id = current;
+    for (int i = 0; i <= CORO_MAX_TASKS; i++) {
+        id = id == CORO_MAX_TASKS ? 0 : id + 1;
+        if (tasks[id].state == CORO_RUNNING) {
+            return id;
+        }
+    }
+    return current;
+}
+
+static void switch_to(int id) {
+    coro_task_t* from = &tasks[current];
+    if (from->canary && *from->canary != CORO_STACK_CANARY) {
+        printf("ERROR: coroutine %d stack overflow\n", current);
+        while(1);
+    }
+    current = id;
+    coro_switch(&from->ctx, &tasks[id].ctx);
+}
+
+int coro_spawn(coro_fn fn, void* arg, void* stack, size_t stack_size) {
+    if (stack_size < CORO_MIN_STACK) {
+        return -1;
+    }
+    for (int id = 1; id <= CORO_MAX_TASKS; id++) {
+        coro_task_t* t = &tasks[id];
+        if (t->state == CORO_RUNNING) {
+            continue;
+        }
+        // Stack grows down from a 16-byte aligned top (ilp32 ABI)
+        uint32_t* bottom = (uint32_t*)(((uintptr_t)stack + 3) & ~3);
+        uintptr_t top = ((uintptr_t)stack + stack_size) & ~15;
+        *bottom = CORO_STACK_CANARY;
+        t->canary = bottom;
+        t->ctx.ra = (uint32_t)(uintptr_t)coro_entry;
+        t->ctx.sp = (uint32_t)top;
+        t->ctx.s[0] = (uint32_t)(uintptr_t)fn;
+        t->ctx.s[1] = (uint32_t)(uintptr_t)arg;
+        t->state = CORO_RUNNING;
+        return id;
+    }
+    return -1;
+}
+
+void coro_yield(void) {
+    int id = next_task();
+    if (id != current) {
+        switch_to(id);
+    }
+}
+
+void coro_wait_until(coro_cond cond, void* arg) {
+    while (!cond(arg)) {
+        coro_yield();
+    }
+}
+
+// Called by coro_entry when a task function returns; task 0 never gets here
+void coro_exit(void) {
+    tasks[current].state = CORO_DONE;
+    switch_to(next_task());
+}
+
+int coro_done(int id) {
+    return id > 0 && id <= CORO_MAX_TASKS && tasks[id].state != CORO_RUNNING;
+}
+
+static int task_done(void* arg) {
+    return coro_done((int)(intptr_t)arg);
+}
+
+void coro_join(int id) {
+    coro_wait_until(task_done, (void*)(intptr_t)id);
+}
+
+int coro_self(void) {
+    return current;
+}
@@ -0,0 +1,42 @@
+/*
+ * Cooperative coroutines for VexRiscv
+ *
+ * Stackful tasks on one CPU, switched only in coro_yield()/coro_wait_until()
+ * (no interrupts, no preemption). The caller of coro_spawn() keeps running on
+ * the start.S stack as task 0, so an existing sequential loop only has to
+ * yield in its waits to let background tasks (terminal/HUD updates, prefetch)
+ * run while it polls a hardware flag.
+ */
+
+#ifndef CORO_H
+#define CORO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CORO_MAX_TASKS   4      /* background tasks, besides task 0 */
+#define CORO_MIN_STACK   256    /* bytes; the stack bottom holds a canary */
+
+typedef void (*coro_fn)(void* arg);
+typedef int (*coro_cond)(void* arg);
+
+/* Start fn(arg) on stack[0..stack_size), runs at the next yield.
+ * Returns the task id (1..CORO_MAX_TASKS), or -1 if no slot is free. */
+int coro_spawn(coro_fn fn, void* arg, void* stack, size_t stack_size);
+
+/* Run the other tasks once, round robin, then return */
+void coro_yield(void);
+
+/* Yield until cond(arg) is non-zero (checked before the first yield) */
+void coro_wait_until(coro_cond cond, void* arg);
+
+/* Task has returned (its slot and stack can be reused) */
+int coro_done(int id);
+
+/* Yield until task id has returned */
+void coro_join(int id);
+
+/* Id of the running task (0 = the caller of coro_spawn) */
+int coro_self(void);
+
+#endif
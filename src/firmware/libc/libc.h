@@ -13,16 +13,33 @@
 /* Memory map constants */
 #define SDRAM_BASE      0x10000000
 #define SDRAM_SIZE      0x04000000  /* 64MB */
-#define SYSREG_BASE     0x40000000
+#define SYSREG_BASE     0x80000000  /* bit 31: VexRiscv IO range, not cached */
+
+/* CPU clock (clk_ram_controller in core_top.v); SYS_CYCLE counts it */
+#define CPU_HZ          133333333
 
 /* System registers */
 #define SYS_STATUS      (*(volatile uint32_t*)(SYSREG_BASE + 0x00))
 #define SYS_CYCLE_LO    (*(volatile uint32_t*)(SYSREG_BASE + 0x04))
 #define SYS_CYCLE_HI    (*(volatile uint32_t*)(SYSREG_BASE + 0x08))
+#define SYS_BUS_OVERLAP (*(volatile uint32_t*)(SYSREG_BASE + 0x0C))  /* cycles with >1 bus transaction in flight */
+
+/* Bridge/CPU SDRAM arbiter (counters run from power-up, across the slot load) */
+#define SYS_SDRAM_ARB        (*(volatile uint32_t*)(SYSREG_BASE + 0x10))  /* R/W: bridge grants per 16 when both wait (16 = bridge priority, 0 = CPU priority) */
+#define SYS_ARB_CPU_OPS      (*(volatile uint32_t*)(SYSREG_BASE + 0x14))  /* SDRAM word operations for the CPU */
+#define SYS_ARB_BRIDGE_OPS   (*(volatile uint32_t*)(SYSREG_BASE + 0x18))  /* SDRAM word operations for the bridge */
+#define SYS_ARB_CPU_WAIT     (*(volatile uint32_t*)(SYSREG_BASE + 0x1C))  /* cycles CPU requests waited for a grant */
+#define SYS_ARB_BRIDGE_WAIT  (*(volatile uint32_t*)(SYSREG_BASE + 0x20))  /* cycles bridge requests waited for a grant */
+#define SYS_ARB_BRIDGE_FIFO_MAX (*(volatile uint32_t*)(SYSREG_BASE + 0x24))  /* most bridge writes queued at once (FIFO of 16) */
+#define SYS_ARB_BRIDGE_OVERFLOW (*(volatile uint32_t*)(SYSREG_BASE + 0x28))  /* 1: a bridge write found the FIFO full and was lost */
+
+/* Data slot CRC32 (zlib), computed as the bridge writes each slot (id 0-3) to SDRAM */
+#define SYS_SLOT_CRC(n)       (*(volatile uint32_t*)(SYSREG_BASE + 0x30 + 4 * (n)))
+#define SYS_SLOT_CRC_BYTES(n) (*(volatile uint32_t*)(SYSREG_BASE + 0x40 + 4 * (n)))  /* bytes hashed (0: slot not loaded over the bridge) */
 
 /* Status bits */
 #define SYS_STATUS_SDRAM_READY          0x01
-#define SYS_STATUS_DATASLOT_COMPLETE    0x02
+#define SYS_STATUS_DATASLOT_COMPLETE    0x02  /* data slots loaded since this CPU reset */
 
 /* ============================================
  * Standard type definitions
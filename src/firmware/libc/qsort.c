@@ -5,8 +5,21 @@
 
 #include "libc.h"
 
-/* Swap two elements */
+/* Swap two elements. Word-aligned elements are swapped a word at a time:
+ * SDRAM and PSRAM have no byte enables, so byte stores there would clobber
+ * the rest of the word (and word accesses are faster anyway). */
 static void swap(void *a, void *b, size_t size) {
+    if ((((uintptr_t)a | (uintptr_t)b | size) & 3) == 0) {
+        uint32_t *wa = (uint32_t *)a;
+        uint32_t *wb = (uint32_t *)b;
+        for (size_t i = 0; i < size / 4; i++) {
+            uint32_t tmp = wa[i];
+            wa[i] = wb[i];
+            wb[i] = tmp;
+        }
+        return;
+    }
+
     uint8_t *pa = (uint8_t *)a;
     uint8_t *pb = (uint8_t *)b;
 
@@ -5,12 +5,6 @@
 
 #include "libc.h"
 
-/* CPU clock frequency in Hz (12.288 MHz) */
-#define CPU_FREQ_HZ     12288000
-
-/* Nanoseconds per cycle (approximately 81.38 ns at 12.288 MHz) */
-#define NS_PER_CYCLE    (1000000000 / CPU_FREQ_HZ)
-
 /* Get 64-bit cycle counter */
 static uint64_t get_cycles(void) {
     uint32_t lo, hi, hi2;
@@ -27,7 +21,7 @@ static uint64_t get_cycles(void) {
 
 time_t time(time_t *tloc) {
     uint64_t cycles = get_cycles();
-    time_t seconds = cycles / CPU_FREQ_HZ;
+    time_t seconds = cycles / CPU_HZ;
 
     if (tloc != NULL) {
         *tloc = seconds;
@@ -46,13 +40,11 @@ int clock_gettime(int clk_id, struct timespec *tp) {
     uint64_t cycles = get_cycles();
 
     /* Calculate seconds and nanoseconds */
-    tp->tv_sec = cycles / CPU_FREQ_HZ;
+    tp->tv_sec = cycles / CPU_HZ;
 
-    uint64_t remaining_cycles = cycles % CPU_FREQ_HZ;
+    uint64_t remaining_cycles = cycles % CPU_HZ;
     /* Convert remaining cycles to nanoseconds */
-    /* remaining_cycles * 1000000000 / CPU_FREQ_HZ */
-    /* To avoid overflow: (remaining_cycles * 1000) / (CPU_FREQ_HZ / 1000000) */
-    tp->tv_nsec = (remaining_cycles * 1000000000ULL) / CPU_FREQ_HZ;
+    tp->tv_nsec = (remaining_cycles * 1000000000ULL) / CPU_HZ;
 
     return 0;
 }
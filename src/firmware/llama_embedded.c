@@ -13,14 +13,26 @@
 #include "libc/libc.h"
 #include "dataslot.h"
 #include "terminal.h"
+#include "coro.h"
 #include "tokenizer_data.h"  /* Embedded tokenizer workaround */
 
+/* Integer matmuls: weights quantized to int8 at load, activations to int16
+ * per matmul input. Off by default: greedy output diverges from fp32 (see
+ * docs/quant-report.md); build with -DQUANT_MATMUL=1 to enable. */
+#ifndef QUANT_MATMUL
+#define QUANT_MATMUL 0
+#endif
+#if QUANT_MATMUL
+#include "quant.h"
+#endif
+#include "attn.h"
+
 /* Redirect printf to terminal */
 #define printf term_printf
 
 /* SDRAM arena for large allocations (RunState) - simple bump allocator */
 #define SDRAM_ARENA_ADDR      0x12100000                  /* After tokenizer data */
-#define SDRAM_ARENA_END       0x14000000                  /* End of 64MB SDRAM */
+#define SDRAM_ARENA_END       0x13F00000                  /* Tokenizer slot above */
 static uint8_t* sdram_arena_ptr = (uint8_t*)SDRAM_ARENA_ADDR;
 
 /* Simple bump allocator for SDRAM - no free, just allocate sequentially */
@@ -58,22 +70,60 @@ static void* psram_cache_alloc(size_t size) {
 #define DEFAULT_STEPS       64      /* Max tokens to generate */
 #define DEFAULT_TEMPERATURE 1.0f    /* Sampling temperature */
 #define DEFAULT_TOPP        0.9f
+#define CYCLES_PER_MS       (CPU_HZ / 1000)  /* SYS_CYCLE runs at the CPU clock (libc.h) */
 #define DEFAULT_PROMPT      "Once upon a time"
 
+#if QUANT_MATMUL
+#define QUANT_ACT_MAX       QUANT_ACT_MAX16  /* QUANT_ACT_MAX8 for int8 activations */
+#define QUANT_MAX_N         2048    /* Longest matmul input (dim, hidden_dim) on the integer path */
+#endif
+
+/* Approximate attention (attn.h): exact scores only for the top ATTN_TOPK
+ * positions by an int4 key shadow, plus the last ATTN_WINDOW; 0 = exact */
+#ifndef ATTN_TOPK
+#define ATTN_TOPK           0
+#endif
+#define ATTN_WINDOW         16
+#define ATTN_MAX_TOPK       64
+#define ATTN_MAX_HEAD       128     /* Longest head_size with a key shadow */
+/* The shadow is only kept when something reads it; the benchmark times
+ * approximate attention at bench_positions whatever ATTN_TOPK is */
+#ifndef RUN_BENCH
+#define RUN_BENCH           0
+#endif
+#ifndef BENCH_MAX_POS
+#define BENCH_MAX_POS       511     /* last bench_positions entry timed (0 = none) */
+#endif
+#define KEY_SHADOW          (ATTN_TOPK > 0 || (RUN_BENCH && BENCH_MAX_POS > 0))
+
+#define MAX_LAYERS          32      /* Per-layer FFN width and projection tables (BRAM) */
+#define LOWRANK_MAX_RANK    256     /* Longest factorized projection intermediate (BRAM) */
+
 /* ============================================
  * Transformer model structures
  * ============================================ */
 
 typedef struct {
     int dim;         /* Transformer dimension */
-    int hidden_dim;  /* FFN hidden dimension */
-    int n_layers;    /* Number of layers */
+    int hidden_dim;  /* FFN hidden dimension (negative: per-layer widths follow, see ffn_dim) */
+    int n_layers;    /* Number of layers (negative: per-layer projection ranks follow, see Proj) */
     int n_heads;     /* Number of attention heads */
     int n_kv_heads;  /* Number of KV heads (can be < n_heads for MQA) */
     int vocab_size;  /* Vocabulary size */
     int seq_len;     /* Max sequence length */
 } Config;
 
+/* Per-layer projections that may be stored factorized */
+enum { PROJ_WO, PROJ_W1, PROJ_W2, PROJ_W3, PROJ_COUNT };
+
+/* One layer's wo/w1/w2/w3 (d x n): dense, or the rank-r factors U (d x r)
+ * and V (r x n), applied as U (V x) in r * (d + n) instead of d * n MACs */
+typedef struct {
+    float* w;       /* dense weights, or U */
+    float* v;       /* V, NULL if dense */
+    int rank;       /* 0 if dense */
+} Proj;
+
 typedef struct {
     float* token_embedding_table;
     float* rms_att_weight;
@@ -81,12 +131,19 @@ typedef struct {
     float* wq;
     float* wk;
     float* wv;
-    float* wo;
-    float* w1;
-    float* w2;
-    float* w3;
     float* rms_final_weight;
     float* wcls;
+    /* FFN hidden width per layer */
+    int* ffn_dim;
+    /* wo/w1/w2/w3 of layer l: proj[l * PROJ_COUNT + PROJ_*] */
+    Proj* proj;
+#if QUANT_MATMUL
+    /* int8 copies of the matmul weights: wq/wk/wv with all layers stacked
+     * row-wise, two per projection (w or U, then V) */
+    int quantized;
+    QuantTensor wq_q, wk_q, wv_q, wcls_q;
+    QuantTensor* proj_q;
+#endif
 } TransformerWeights;
 
 typedef struct {
@@ -102,6 +159,13 @@ typedef struct {
     float *logits;
     float* key_cache;
     float* value_cache;
+    uint32_t* key_shadow;       /* int4 keys (attn.h), NULL if not allocated */
+    uint32_t* key_shadow_scale; /* fixed-point shadow scales (attn.h) */
+    int attn_topk;              /* 0: exact attention */
+#if QUANT_MATMUL
+    QuantVec xq;    /* current matmul input, quantized */
+    QuantVec tq;    /* low-rank intermediate V x, quantized */
+#endif
 } RunState;
 
 typedef struct {
@@ -128,6 +192,9 @@ typedef struct {
     int vocab_size;
     unsigned int max_token_length;
     unsigned char byte_pieces[512];
+    int bos_id;         /* looked up by piece: a trimmed vocab remaps ids */
+    int eos_id;
+    int byte_base;      /* id of <0x00>; the 256 byte fallbacks are contiguous */
 } Tokenizer;
 
 /* Global pointer for str_lookup to access vocab without qsort */
@@ -183,6 +250,27 @@ static void malloc_run_state(RunState* s, Config* p) {
     printf("KV cache in SDRAM (%d KB x2)\n", kv_cache_size / 1024);
     #endif
 
+    /* int4 key shadow for approximate attention, next to the KV cache */
+    s->key_shadow = NULL;
+    s->key_shadow_scale = NULL;
+    #if KEY_SHADOW
+    int head_size = p->dim / p->n_heads;
+    int shadow_scales = p->n_layers * p->seq_len * p->n_kv_heads;
+    int shadow_size = shadow_scales * attn_shadow_words(head_size) * sizeof(uint32_t);
+    if (head_size <= ATTN_MAX_HEAD) {
+        s->key_shadow = psram_cache_alloc(shadow_size);
+        s->key_shadow_scale = psram_cache_alloc(shadow_scales * sizeof(uint32_t));
+        if (!s->key_shadow || !s->key_shadow_scale) {
+            s->key_shadow = sdram_alloc(shadow_size);
+            s->key_shadow_scale = sdram_alloc(shadow_scales * sizeof(uint32_t));
+        }
+        if (!s->key_shadow_scale) {
+            s->key_shadow = NULL;
+        }
+    }
+    #endif
+    s->attn_topk = s->key_shadow ? (ATTN_TOPK < ATTN_MAX_TOPK ? ATTN_TOPK : ATTN_MAX_TOPK) : 0;
+
     s->att = sdram_alloc(p->n_heads * p->seq_len * sizeof(float));
     s->logits = sdram_alloc(p->vocab_size * sizeof(float));
 
@@ -193,6 +281,23 @@ static void malloc_run_state(RunState* s, Config* p) {
     }
 }
 
+#if QUANT_MATMUL
+/* Quantized matmul input lives in BRAM: it is read once per output row and
+ * int16 stores need byte enables, which SDRAM/PSRAM don't have */
+static int16_t quant_act_buf[QUANT_MAX_N + 4];
+static int16_t lowrank_act_buf[LOWRANK_MAX_RANK + 4];
+#endif
+
+/* Factorized projection intermediate V x (BRAM): written once, read once
+ * per output row of U */
+static float lowrank_buf[LOWRANK_MAX_RANK];
+
+/* Approximate attention scratch (BRAM): selected positions, stage 1 scores
+ * and the int16 query (byte-writable memory) */
+static int attn_sel[ATTN_MAX_TOPK + ATTN_WINDOW];
+static int32_t attn_sel_score[ATTN_MAX_TOPK + ATTN_WINDOW];
+static int16_t attn_qq[ATTN_MAX_HEAD];
+
 static void free_run_state(RunState* s) {
     (void)s;  /* SDRAM bump allocator doesn't free */
 }
@@ -201,7 +306,35 @@ static void free_run_state(RunState* s) {
  * Weight memory mapping
  * ============================================ */
 
-static void memory_map_weights(TransformerWeights *w, Config* p, float* ptr, int shared_weights) {
+/* Output and input size of projection k of layer l */
+static void proj_shape(const TransformerWeights* w, const Config* p, int l, int k, int* d, int* n) {
+    *d = (k == PROJ_W1 || k == PROJ_W3) ? w->ffn_dim[l] : p->dim;
+    *n = k == PROJ_W2 ? w->ffn_dim[l] : p->dim;
+}
+
+/* Map projection k of every layer from ptr: dense d x n, or V (rank x n)
+ * followed by U (d x rank). Ranks are already set. Returns the end. */
+static float* map_projs(TransformerWeights* w, Config* p, float* ptr, int k) {
+    for (int l = 0; l < p->n_layers; l++) {
+        Proj* pr = &w->proj[l * PROJ_COUNT + k];
+        int d, n;
+        proj_shape(w, p, l, k, &d, &n);
+        if (pr->rank) {
+            pr->v = ptr;
+            ptr += pr->rank * n;
+            pr->w = ptr;
+            ptr += d * pr->rank;
+        } else {
+            pr->v = NULL;
+            pr->w = ptr;
+            ptr += d * n;
+        }
+    }
+    return ptr;
+}
+
+/* Returns the end of the checkpoint */
+static float* memory_map_weights(TransformerWeights *w, Config* p, float* ptr, int shared_weights) {
     int head_size = p->dim / p->n_heads;
     unsigned long long n_layers = p->n_layers;
 
@@ -215,27 +348,161 @@ static void memory_map_weights(TransformerWeights *w, Config* p, float* ptr, int
     ptr += n_layers * p->dim * (p->n_kv_heads * head_size);
     w->wv = ptr;
     ptr += n_layers * p->dim * (p->n_kv_heads * head_size);
-    w->wo = ptr;
-    ptr += n_layers * (p->n_heads * head_size) * p->dim;
+    ptr = map_projs(w, p, ptr, PROJ_WO);
     w->rms_ffn_weight = ptr;
     ptr += n_layers * p->dim;
-    w->w1 = ptr;
-    ptr += n_layers * p->dim * p->hidden_dim;
-    w->w2 = ptr;
-    ptr += n_layers * p->hidden_dim * p->dim;
-    w->w3 = ptr;
-    ptr += n_layers * p->dim * p->hidden_dim;
+    ptr = map_projs(w, p, ptr, PROJ_W1);
+    ptr = map_projs(w, p, ptr, PROJ_W2);
+    ptr = map_projs(w, p, ptr, PROJ_W3);
     w->rms_final_weight = ptr;
     ptr += p->dim;
     ptr += p->seq_len * head_size / 2; /* skip freq_cis_real */
     ptr += p->seq_len * head_size / 2; /* skip freq_cis_imag */
     w->wcls = shared_weights ? w->token_embedding_table : ptr;
+    if (!shared_weights) ptr += p->vocab_size * p->dim;
+    return ptr;
+}
+
+#if QUANT_MATMUL
+static int quantize_tensor(QuantTensor* t, const float* w, int rows, int n) {
+    t->q = sdram_alloc(rows * quant_row_words(n) * sizeof(uint32_t));
+    t->s = sdram_alloc(rows * sizeof(float));
+    if (!t->q || !t->s) return 0;
+    quantize_weights(t, w, rows, n);
+    return 1;
+}
+
+/* int8 copies of every matmul weight in the SDRAM arena. Falls back to fp32
+ * matmuls if the activations don't fit quant_act_buf or the arena is full. */
+static void quantize_transformer(TransformerWeights* w, Config* p) {
+    int dim = p->dim;
+    int kv_dim = (p->dim * p->n_kv_heads) / p->n_heads;
+    int hidden_dim = p->hidden_dim;
+    int L = p->n_layers;
+
+    w->quantized = 0;
+    if (dim > QUANT_MAX_N || hidden_dim > QUANT_MAX_N) {
+        printf("fp32 matmul (dim/hidden > %d)\n", QUANT_MAX_N);
+        return;
+    }
+    uint32_t start = SYS_CYCLE_LO;
+    uint8_t* arena_start = sdram_arena_ptr;
+    if (!quantize_tensor(&w->wq_q, w->wq, L * dim, dim) ||
+        !quantize_tensor(&w->wk_q, w->wk, L * kv_dim, dim) ||
+        !quantize_tensor(&w->wv_q, w->wv, L * kv_dim, dim) ||
+        !quantize_tensor(&w->wcls_q, w->wcls, p->vocab_size, dim) ||
+        !(w->proj_q = sdram_alloc(L * PROJ_COUNT * 2 * sizeof(QuantTensor)))) {
+        printf("fp32 matmul (SDRAM arena full)\n");
+        return;
+    }
+    for (int i = 0; i < L * PROJ_COUNT; i++) {
+        Proj* pr = &w->proj[i];
+        QuantTensor* q = &w->proj_q[2 * i];
+        int d, n;
+        proj_shape(w, p, i / PROJ_COUNT, i % PROJ_COUNT, &d, &n);
+        int ok = pr->rank ? quantize_tensor(&q[0], pr->w, d, pr->rank) && quantize_tensor(&q[1], pr->v, pr->rank, n)
+                          : quantize_tensor(&q[0], pr->w, d, n);
+        if (!ok) {
+            printf("fp32 matmul (SDRAM arena full)\n");
+            return;
+        }
+    }
+    w->quantized = 1;
+    printf("int8 weights: %d KB in %u ms\n", (int)(sdram_arena_ptr - arena_start) / 1024,
+           (SYS_CYCLE_LO - start) / CYCLES_PER_MS);
+}
+#endif
+
+/* ============================================
+ * Data slot checksums
+ * ============================================ */
+
+/* Trailer after the last tensor of model.bin and the last token of
+ * tokenizer.bin: magic, then the CRC32 of every byte before it
+ * (tools/model_checksum.py) */
+#define SLOT_CRC_MAGIC      0x32335243  /* "CR32" */
+#define SLOT_CRC_BYTES      8
+#define MODEL_SLOT_ID       0
+#define TOKENIZER_SLOT_ID   1
+
+/* Read 32-bit value from potentially unaligned address using only word-aligned reads */
+static inline uint32_t read_u32(const uint8_t* ptr) {
+    uintptr_t addr = (uintptr_t)ptr;
+    uintptr_t aligned_addr = addr & ~3;
+    int offset = addr & 3;
+
+    /* Read the aligned word(s) */
+    uint32_t w0 = *(const volatile uint32_t*)aligned_addr;
+
+    if (offset == 0) {
+        return w0;
+    }
+
+    /* Need to read next word and combine */
+    uint32_t w1 = *(const volatile uint32_t*)(aligned_addr + 4);
+
+    /* Extract bytes from the two words based on offset */
+    return (w0 >> (offset * 8)) | (w1 << ((4 - offset) * 8));
+}
+
+/* zlib-compatible CRC32 (reflected, poly 0xEDB88320), continues from crc */
+static uint32_t crc32_update(uint32_t crc, const uint8_t* p, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+/*
+ * Compare the CRC32 dataslot_crc computed while the bridge wrote a slot
+ * against the trailer stored in the file, at end (NULL: the last
+ * SLOT_CRC_BYTES of the slot). The hardware hashes the whole slot, trailer
+ * included, so the stored CRC is continued over the trailer bytes. Halts on
+ * a mismatch: dropped or corrupted bridge words would otherwise only show up
+ * as garbage output.
+ */
+static void check_slot_crc(const char* name, int slot, const uint8_t* data, const uint8_t* end) {
+    uint32_t hw_bytes = SYS_SLOT_CRC_BYTES(slot);
+    uint32_t hw_crc = SYS_SLOT_CRC(slot);
+    if (hw_bytes == 0) {
+        printf("%s CRC: slot not loaded over the bridge\n", name);
+        return;
+    }
+    if (!end) {
+        end = data + (hw_bytes < SLOT_CRC_BYTES ? 0 : hw_bytes - SLOT_CRC_BYTES);
+    }
+    /* The tokenizer trailer need not be word aligned */
+    uint32_t trailer[2] = { read_u32(end), read_u32(end + 4) };
+    if (trailer[0] != SLOT_CRC_MAGIC) {
+        printf("%s CRC %08X (%u bytes, no checksum in file)\n", name, hw_crc, hw_bytes);
+        return;
+    }
+    uint32_t size = (uint32_t)(end - data) + SLOT_CRC_BYTES;
+    uint32_t expected = crc32_update(trailer[1], (const uint8_t*)trailer, SLOT_CRC_BYTES);
+    if (hw_crc != expected || hw_bytes != size) {
+        printf("ERROR: %s CRC %08X over %u bytes, expected %08X over %u\n",
+               name, hw_crc, hw_bytes, expected, size);
+        while(1);
+    }
+    printf("%s CRC OK (%08X)\n", name, trailer[1]);
 }
 
 /* ============================================
  * Build transformer from SDRAM data
  * ============================================ */
 
+/* FFN width per layer (BRAM): from the table after the Config header when
+ * hidden_dim is negative (structurally pruned checkpoints), else uniform */
+static int ffn_dim_table[MAX_LAYERS];
+
+/* wo/w1/w2/w3 per layer (BRAM); ranks from the table after the widths when
+ * n_layers is negative (tools/lowrank.c), else all dense */
+static Proj proj_table[MAX_LAYERS * PROJ_COUNT];
+
 static void build_transformer_from_memory(Transformer *t, void* data, size_t size) {
     Config* config = (Config*)data;
     t->config = *config;
@@ -244,8 +511,77 @@ static void build_transformer_from_memory(Transformer *t, void* data, size_t siz
     t->config.vocab_size = abs(config->vocab_size);
 
     float* weights_ptr = (float*)((char*)data + sizeof(Config));
-    memory_map_weights(&t->weights, &t->config, weights_ptr, shared_weights);
+    int L = abs(config->n_layers);
+    t->config.n_layers = L;
+    if (L > MAX_LAYERS) {
+        printf("ERROR: %d layers (max %d)\n", L, MAX_LAYERS);
+        while(1);
+    }
+    const int* widths = NULL;
+    if (config->hidden_dim < 0) {
+        widths = (const int*)weights_ptr;
+        weights_ptr += L;
+    }
+    t->config.hidden_dim = 0;
+    int ffn_rows = 0;
+    for (int l = 0; l < L; l++) {
+        ffn_dim_table[l] = widths ? widths[l] : config->hidden_dim;
+        ffn_rows += ffn_dim_table[l];
+        if (ffn_dim_table[l] > t->config.hidden_dim) t->config.hidden_dim = ffn_dim_table[l];
+    }
+    t->weights.ffn_dim = ffn_dim_table;
+    if (widths) {
+        printf("FFN widths: %d rows over %d layers (max %d)\n", ffn_rows, L, t->config.hidden_dim);
+    }
+
+    const int* ranks = NULL;
+    if (config->n_layers < 0) {
+        ranks = (const int*)weights_ptr;
+        weights_ptr += L * PROJ_COUNT;
+    }
+    int factored = 0;
+    for (int i = 0; i < L * PROJ_COUNT; i++) {
+        proj_table[i].rank = ranks ? ranks[i] : 0;
+        if (proj_table[i].rank < 0 || proj_table[i].rank > LOWRANK_MAX_RANK) {
+            printf("ERROR: projection rank %d (max %d)\n", proj_table[i].rank, LOWRANK_MAX_RANK);
+            while(1);
+        }
+        factored += proj_table[i].rank > 0;
+    }
+    t->weights.proj = proj_table;
+    if (ranks) {
+        printf("Low-rank: %d of %d projections\n", factored, L * PROJ_COUNT);
+    }
+
+    uint8_t* end = (uint8_t*)memory_map_weights(&t->weights, &t->config, weights_ptr, shared_weights);
+
+    /* Large checkpoints run into the arena: start it after the weights */
+    if (end > (uint8_t*)SDRAM_ARENA_END) {
+        printf("ERROR: model (%d KB) overlaps the tokenizer slot\n", (int)(end - (uint8_t*)data) / 1024);
+        while(1);
+    }
+    check_slot_crc("Model", MODEL_SLOT_ID, (const uint8_t*)data, end);
+    if (end > sdram_arena_ptr) {
+        sdram_arena_ptr = (uint8_t*)(((uintptr_t)end + 7) & ~7);
+    }
+    uint8_t* arena_start = sdram_arena_ptr;
     malloc_run_state(&t->state, &t->config);
+    int quantized = 0;
+#if QUANT_MATMUL
+    t->state.xq.q = quant_act_buf;
+    t->state.tq.q = lowrank_act_buf;
+    quantize_transformer(&t->weights, &t->config);
+    quantized = t->weights.quantized;
+#endif
+
+    /* tools/model_sweep.py reports placement from this line */
+    RunState* s = &t->state;
+    printf("Placement: arena=%uKB psram_cache=%uKB kv=%s key_shadow=%s matmul=%s\n",
+           (unsigned)(sdram_arena_ptr - arena_start) / 1024,
+           (unsigned)(psram_cache_ptr - (uint8_t*)PSRAM_CACHE_ADDR) / 1024,
+           (uintptr_t)s->key_cache >= PSRAM_CACHE_ADDR ? "PSRAM" : "SDRAM",
+           !s->key_shadow ? "none" : (uintptr_t)s->key_shadow >= PSRAM_CACHE_ADDR ? "PSRAM" : "SDRAM",
+           quantized ? "int8" : "fp32");
 
     t->data = data;
     t->file_size = size;
@@ -311,6 +647,36 @@ static void matmul(float* xout, float* x, float* w, int n, int d) {
     }
 }
 
+/* xout (d) = projection proj_idx applied to x (n). On the int8 path the caller
+ * has quantized x into s->xq. Factorized projections go through lowrank_buf:
+ * t = V x, then xout = U t. */
+static void matmul_proj(TransformerWeights* w, RunState* s, float* xout, float* x, int proj_idx, int n, int d) {
+    Proj* pr = &w->proj[proj_idx];
+#if QUANT_MATMUL
+    if (w->quantized) {
+        QuantTensor* q = &w->proj_q[2 * proj_idx];
+        if (pr->rank) {
+            matmul_q(lowrank_buf, &s->xq, &q[1], 0, pr->rank);
+            quantize_vec(&s->tq, lowrank_buf, pr->rank, QUANT_ACT_MAX);
+            matmul_q(xout, &s->tq, &q[0], 0, d);
+        } else {
+            matmul_q(xout, &s->xq, &q[0], 0, d);
+        }
+        return;
+    }
+#else
+    (void)s;
+#endif
+    if (pr->rank) {
+        matmul(lowrank_buf, x, pr->v, n, pr->rank);
+        matmul(xout, lowrank_buf, pr->w, pr->rank, d);
+    } else {
+        matmul(xout, x, pr->w, n, d);
+    }
+}
+
+/* Yields (coro.h) after each group of matmuls, so the console and HUD tasks
+ * of generate() run in small steps while it computes */
 static float* forward(Transformer* transformer, int token, int pos) {
     Config* p = &transformer->config;
     TransformerWeights* w = &transformer->weights;
@@ -319,7 +685,6 @@ static float* forward(Transformer* transformer, int token, int pos) {
     int dim = p->dim;
     int kv_dim = (p->dim * p->n_kv_heads) / p->n_heads;
     int kv_mul = p->n_heads / p->n_kv_heads;
-    int hidden_dim = p->hidden_dim;
     int head_size = dim / p->n_heads;
 
     float* content_row = w->token_embedding_table + token * dim;
@@ -333,9 +698,20 @@ static float* forward(Transformer* transformer, int token, int pos) {
         s->k = s->key_cache + loff + pos * kv_dim;
         s->v = s->value_cache + loff + pos * kv_dim;
 
-        matmul(s->q, s->xb, w->wq + l*dim*dim, dim, dim);
-        matmul(s->k, s->xb, w->wk + l*dim*kv_dim, dim, kv_dim);
-        matmul(s->v, s->xb, w->wv + l*dim*kv_dim, dim, kv_dim);
+#if QUANT_MATMUL
+        if (w->quantized) {
+            quantize_vec(&s->xq, s->xb, dim, QUANT_ACT_MAX);
+            matmul_q(s->q, &s->xq, &w->wq_q, l*dim, dim);
+            matmul_q(s->k, &s->xq, &w->wk_q, l*kv_dim, kv_dim);
+            matmul_q(s->v, &s->xq, &w->wv_q, l*kv_dim, kv_dim);
+        } else
+#endif
+        {
+            matmul(s->q, s->xb, w->wq + l*dim*dim, dim, dim);
+            matmul(s->k, s->xb, w->wk + l*dim*kv_dim, dim, kv_dim);
+            matmul(s->v, s->xb, w->wv + l*dim*kv_dim, dim, kv_dim);
+        }
+        coro_yield();
 
         for (int i = 0; i < dim; i += 2) {
             int head_dim = i % head_size;
@@ -353,9 +729,37 @@ static float* forward(Transformer* transformer, int token, int pos) {
             }
         }
 
+        /* int4 shadow of the new key, kept whenever allocated so attn_topk
+         * can change at any position */
+        int sw = attn_shadow_words(head_size);
+        int soff = l * p->seq_len * p->n_kv_heads;
+        #if KEY_SHADOW
+        if (s->key_shadow) {
+            int koff = soff + pos * p->n_kv_heads;
+            for (int g = 0; g < p->n_kv_heads; g++) {
+                attn_shadow_key(s->key_shadow + (koff + g) * sw, s->key_shadow_scale + koff + g,
+                                s->k + g * head_size, head_size);
+            }
+        }
+        #endif
+
         for (int h = 0; h < p->n_heads; h++) {
             float* q = s->q + h * head_size;
             float* att = s->att + h * p->seq_len;
+
+            if (s->attn_topk > 0) {
+                int g = h / kv_mul;
+                AttnHead a = {
+                    s->key_cache + loff + g * head_size, s->value_cache + loff + g * head_size, kv_dim,
+                    s->key_shadow + (soff + g) * sw, s->key_shadow_scale + soff + g,
+                    p->n_kv_heads * sw, p->n_kv_heads, head_size
+                };
+                attn_query(attn_qq, q, head_size);
+                attn_head_approx(s->xb + h * head_size, q, attn_qq, &a, pos, s->attn_topk, ATTN_WINDOW,
+                                 attn_sel, attn_sel_score, att);
+                continue;
+            }
+
             for (int t = 0; t <= pos; t++) {
                 float* k = s->key_cache + loff + t * kv_dim + (h / kv_mul) * head_size;
                 float score = 0.0f;
@@ -379,7 +783,14 @@ static float* forward(Transformer* transformer, int token, int pos) {
             }
         }
 
-        matmul(s->xb2, s->xb, w->wo + l*dim*dim, dim, dim);
+        int proj = l * PROJ_COUNT;
+#if QUANT_MATMUL
+        if (w->quantized) {
+            quantize_vec(&s->xq, s->xb, dim, QUANT_ACT_MAX);
+        }
+#endif
+        matmul_proj(w, s, s->xb2, s->xb, proj + PROJ_WO, dim, dim);
+        coro_yield();
 
         for (int i = 0; i < dim; i++) {
             x[i] += s->xb2[i];
@@ -387,8 +798,16 @@ static float* forward(Transformer* transformer, int token, int pos) {
 
         rmsnorm(s->xb, x, w->rms_ffn_weight + l*dim, dim);
 
-        matmul(s->hb, s->xb, w->w1 + l*dim*hidden_dim, dim, hidden_dim);
-        matmul(s->hb2, s->xb, w->w3 + l*dim*hidden_dim, dim, hidden_dim);
+        int hidden_dim = w->ffn_dim[l];
+
+#if QUANT_MATMUL
+        if (w->quantized) {
+            quantize_vec(&s->xq, s->xb, dim, QUANT_ACT_MAX);
+        }
+#endif
+        matmul_proj(w, s, s->hb, s->xb, proj + PROJ_W1, dim, hidden_dim);
+        matmul_proj(w, s, s->hb2, s->xb, proj + PROJ_W3, dim, hidden_dim);
+        coro_yield();
 
         /* SwiGLU activation: silu(x) * gate, where silu(x) = x * sigmoid(x) */
         for (int i = 0; i < hidden_dim; i++) {
@@ -398,7 +817,13 @@ static float* forward(Transformer* transformer, int token, int pos) {
             s->hb[i] = val;
         }
 
-        matmul(s->xb, s->hb, w->w2 + l*dim*hidden_dim, hidden_dim, dim);
+#if QUANT_MATMUL
+        if (w->quantized) {
+            quantize_vec(&s->xq, s->hb, hidden_dim, QUANT_ACT_MAX);
+        }
+#endif
+        matmul_proj(w, s, s->xb, s->hb, proj + PROJ_W2, hidden_dim, dim);
+        coro_yield();
 
         for (int i = 0; i < dim; i++) {
             x[i] += s->xb[i];
@@ -406,6 +831,12 @@ static float* forward(Transformer* transformer, int token, int pos) {
     }
 
     rmsnorm(x, x, w->rms_final_weight, dim);
+#if QUANT_MATMUL
+    if (w->quantized) {
+        quantize_vec(&s->xq, x, dim, QUANT_ACT_MAX);
+        matmul_q(s->logits, &s->xq, &w->wcls_q, 0, p->vocab_size);
+    } else
+#endif
     matmul(s->logits, x, w->wcls, p->dim, p->vocab_size);
     return s->logits;
 }
@@ -418,26 +849,6 @@ static int compare_tokens(const void *a, const void *b) {
     return strcmp(((TokenIndex*)a)->str, ((TokenIndex*)b)->str);
 }
 
-/* Read 32-bit value from potentially unaligned address using only word-aligned reads */
-static inline uint32_t read_u32(const uint8_t* ptr) {
-    uintptr_t addr = (uintptr_t)ptr;
-    uintptr_t aligned_addr = addr & ~3;
-    int offset = addr & 3;
-
-    /* Read the aligned word(s) */
-    uint32_t w0 = *(const volatile uint32_t*)aligned_addr;
-
-    if (offset == 0) {
-        return w0;
-    }
-
-    /* Need to read next word and combine */
-    uint32_t w1 = *(const volatile uint32_t*)(aligned_addr + 4);
-
-    /* Extract bytes from the two words based on offset */
-    return (w0 >> (offset * 8)) | (w1 << ((4 - offset) * 8));
-}
-
 /* Helper to read potentially unaligned float */
 static inline float read_float(const uint8_t* ptr) {
     uint32_t bits = read_u32(ptr);
@@ -462,9 +873,29 @@ static char* tok_string_ptr = NULL;
 #define ENCODE_BUFFER_SIZE 256       /* For BPE string operations */
 static char encode_str_buffer[ENCODE_BUFFER_SIZE];
 
+/* Special token ids of the stock llama2.c vocab; tools/trim_vocab.py keeps
+ * them, but find them by piece so any compacted vocab works. */
+static void find_special_tokens(Tokenizer* t) {
+    t->bos_id = 1;
+    t->eos_id = 2;
+    t->byte_base = 3;
+    for (int i = 0; i < t->vocab_size; i++) {
+        if (strcmp(t->vocab[i], "\n<s>\n") == 0) t->bos_id = i;
+        else if (strcmp(t->vocab[i], "\n</s>\n") == 0) t->eos_id = i;
+        else if (strcmp(t->vocab[i], "<0x00>") == 0) t->byte_base = i;
+    }
+    if (t->byte_base + 256 > t->vocab_size) {
+        printf("ERROR: byte fallbacks missing from vocab (<0x00> at %d)\n", t->byte_base);
+        while (1);
+    }
+}
+
 static void build_tokenizer_from_memory(Tokenizer* t, void* data, int vocab_size) {
     t->vocab_size = vocab_size;
     t->sorted_vocab = NULL;
+    t->bos_id = 1;
+    t->eos_id = 2;
+    t->byte_base = 3;
 
     /* Allocate vocab pointers, scores, and string pool from PSRAM heap */
     tok_vocab_ptrs = (char**)malloc(vocab_size * sizeof(char*));
@@ -493,18 +924,7 @@ static void build_tokenizer_from_memory(Tokenizer* t, void* data, int vocab_size
     printf("  Tok at 0x%08X\n", (uint32_t)data);
 
     /* Read max_token_length */
-    uint32_t raw_max_tok = read_u32(ptr);
-    printf("  raw max_token_length=%d (0x%08X)\n", raw_max_tok, raw_max_tok);
-
-    /* WORKAROUND: The first word of tokenizer data gets corrupted by CDC bug.
-     * Known corruption: 0x07 -> 0x1B (bits 3,4 set incorrectly)
-     * If we detect this pattern, use the correct value. */
-    if (raw_max_tok == 0x1B) {
-        t->max_token_length = 7;  /* Correct value for tokenizer.bin */
-        printf("  WORKAROUND: Corrected to %d\n", t->max_token_length);
-    } else {
-        t->max_token_length = raw_max_tok;
-    }
+    t->max_token_length = read_u32(ptr);
     printf("  max_token_length=%d\n", t->max_token_length);
     ptr += 4;
 
@@ -581,11 +1001,36 @@ static void build_tokenizer_from_memory(Tokenizer* t, void* data, int vocab_size
 
         ptr += len;
     }
-    printf("Tokenizer: %d tokens loaded\n", vocab_size);
+    find_special_tokens(t);
+    printf("Tokenizer: %d tokens loaded (BOS %d, EOS %d)\n", vocab_size, t->bos_id, t->eos_id);
 }
 
 static void free_tokenizer(Tokenizer* t) {
-    (void)t;  /* SDRAM bump allocator doesn't free */
+    (void)t;
+    /* Buffers come from the PSRAM heap (see build_tokenizer_from_memory) */
+    free(tok_vocab_ptrs);
+    free(tok_scores_ptr);
+    free(tok_string_pool);
+    tok_vocab_ptrs = NULL;
+    tok_scores_ptr = NULL;
+    tok_string_pool = NULL;
+}
+
+/* Number of tokens in a tokenizer.bin image: max_token_length, then
+ * {score, len, bytes[len]} per token up to the checksum trailer or the end
+ * of the data */
+static int tokenizer_vocab_size(const uint8_t* data, uint32_t size) {
+    const uint8_t* ptr = data + 4;
+    const uint8_t* end = data + size;
+    int n = 0;
+    while (ptr + 8 <= end) {
+        if (ptr + SLOT_CRC_BYTES == end && read_u32(ptr) == SLOT_CRC_MAGIC) break;
+        int32_t len = (int32_t)read_u32(ptr + 4);
+        if (len < 0 || ptr + 8 + len > end) break;
+        ptr += 8 + len;
+        n++;
+    }
+    return n;
 }
 
 /* Parse <0xXX> format manually (sscanf doesn't support %hhX) */
@@ -623,7 +1068,7 @@ static char* decode(Tokenizer* t, int prev_token, int token) {
     if (piece == NULL) {
         return "(NULL)";
     }
-    if (prev_token == 1 && piece[0] == ' ') { piece++; }
+    if (prev_token == t->bos_id && piece[0] == ' ') { piece++; }
 
     /* Handle <0xXX> format byte tokens */
     unsigned char byte_val;
@@ -633,16 +1078,17 @@ static char* decode(Tokenizer* t, int prev_token, int token) {
     return piece;
 }
 
-static void safe_printf(char *piece) {
-    if (piece == NULL) { return; }
-    if (piece[0] == '\0') { return; }
+/* Skip empty pieces and raw control bytes */
+static int printable_piece(const char *piece) {
+    if (piece == NULL) { return 0; }
+    if (piece[0] == '\0') { return 0; }
     if (piece[1] == '\0') {
         unsigned char byte_val = piece[0];
         if (!(isprint(byte_val) || isspace(byte_val))) {
-            return;
+            return 0;
         }
     }
-    printf("%s", piece);
+    return 1;
 }
 
 /* Linear search - slower but avoids qsort which is too slow with SDRAM strings */
@@ -677,7 +1123,7 @@ static void encode(Tokenizer* t, char *text, int8_t bos, int8_t eos, int *tokens
 
     *n_tokens = 0;
 
-    if (bos) tokens[(*n_tokens)++] = 1;
+    if (bos) tokens[(*n_tokens)++] = t->bos_id;
 
     if (text[0] != '\0') {
         int dummy_prefix = str_lookup(" ", t->sorted_vocab, t->vocab_size);
@@ -704,7 +1150,7 @@ static void encode(Tokenizer* t, char *text, int8_t bos, int8_t eos, int *tokens
             tokens[(*n_tokens)++] = id;
         } else {
             for (size_t i = 0; i < str_len; i++) {
-                tokens[(*n_tokens)++] = (unsigned char)str_buffer[i] + 3;
+                tokens[(*n_tokens)++] = t->byte_base + (unsigned char)str_buffer[i];
             }
         }
         str_len = 0;
@@ -737,7 +1183,7 @@ static void encode(Tokenizer* t, char *text, int8_t bos, int8_t eos, int *tokens
         (*n_tokens)--;
     }
 
-    if (eos) tokens[(*n_tokens)++] = 2;
+    if (eos) tokens[(*n_tokens)++] = t->eos_id;
 
     /* str_buffer is static BRAM, no free needed */
 }
@@ -857,6 +1303,83 @@ static int sample(Sampler* sampler, float* logits) {
  * Generation loop
  * ============================================ */
 
+static uint64_t read_cycles(void) {
+    return ((uint64_t)SYS_CYCLE_HI << 32) | SYS_CYCLE_LO;
+}
+
+/*
+ * Generated text goes through a ring to a console task, which prints
+ * CONSOLE_BURST characters per step: a line that scrolls the terminal is
+ * spread over the next forward() instead of delaying it. generate() only
+ * waits when the ring is full. Without a task slot it prints directly.
+ */
+#define CONSOLE_RING        256     /* bytes, power of 2 */
+#define CONSOLE_BURST       8
+#define GEN_HUD_MS          500
+
+static uint32_t hud_stack[256];        /* 1KB, BRAM: load progress, then the generation HUD */
+static uint32_t console_stack[128];    /* 512B, BRAM */
+
+typedef struct {
+    char buf[CONSOLE_RING];
+    volatile uint32_t head;     /* queued */
+    volatile uint32_t tail;     /* printed */
+    volatile int stop;          /* task returns once the ring is empty */
+    int task;
+} Console;
+
+static void console_task(void* arg) {
+    Console* c = (Console*)arg;
+    while (!c->stop || c->tail != c->head) {
+        for (int i = 0; i < CONSOLE_BURST && c->tail != c->head; i++) {
+            term_putchar(c->buf[c->tail & (CONSOLE_RING - 1)]);
+            c->tail++;
+        }
+        coro_yield();
+    }
+}
+
+static int console_has_room(void* arg) {
+    Console* c = (Console*)arg;
+    return c->head - c->tail < CONSOLE_RING;
+}
+
+static void console_puts(Console* c, const char* str) {
+    if (c->task <= 0) {
+        printf("%s", str);
+        return;
+    }
+    for (; *str; str++) {
+        coro_wait_until(console_has_room, c);
+        c->buf[c->head & (CONSOLE_RING - 1)] = *str;
+        c->head++;
+    }
+}
+
+/* Position and speed on the top row (term_status), every GEN_HUD_MS */
+typedef struct {
+    volatile int pos;
+    volatile uint64_t start;    /* cycles at the first generated token, 0 before */
+    volatile int stop;
+    int steps;
+} GenHud;
+
+static void gen_hud_task(void* arg) {
+    GenHud* h = (GenHud*)arg;
+    uint64_t last = 0;
+    while (!h->stop) {
+        uint64_t now = read_cycles();
+        if (now - last >= (uint64_t)GEN_HUD_MS * CYCLES_PER_MS) {
+            last = now;
+            uint32_t ms = h->start ? (uint32_t)((now - h->start) / CYCLES_PER_MS) : 0;
+            uint32_t tok_per_min = ms ? (uint32_t)((uint64_t)(h->pos - 1) * 60000 / ms) : 0;
+            term_status("Token %d/%d  %u tok/min", h->pos, h->steps, tok_per_min);
+        }
+        coro_yield();
+    }
+    term_status_end();
+}
+
 static void generate(Transformer *transformer, Tokenizer *tokenizer, Sampler *sampler, char *prompt, int steps) {
     char *empty_prompt = "";
     if (prompt == NULL) { prompt = empty_prompt; }
@@ -875,10 +1398,18 @@ static void generate(Transformer *transformer, Tokenizer *tokenizer, Sampler *sa
     }
 
     uint64_t start_cycles = 0;
+    uint32_t ttft_ms = 0;
     int next;
     int token = prompt_tokens[0];
     int pos = 0;
 
+    static Console console;
+    console.head = console.tail = 0;
+    console.stop = 0;
+    console.task = coro_spawn(console_task, &console, console_stack, sizeof(console_stack));
+    GenHud hud = { .pos = 0, .start = 0, .stop = 0, .steps = steps };
+    int hud_task = coro_spawn(gen_hud_task, &hud, hud_stack, sizeof(hud_stack));
+
     while (pos < steps) {
         float* logits = forward(transformer, token, pos);
 
@@ -889,30 +1420,47 @@ static void generate(Transformer *transformer, Tokenizer *tokenizer, Sampler *sa
         }
         pos++;
 
-        if (next == 1) { break; }
+        if (next == tokenizer->bos_id) { break; }
 
         char* piece = decode(tokenizer, token, next);
-        safe_printf(piece);
+        if (printable_piece(piece)) {
+            console_puts(&console, piece);
+        }
         token = next;
 
         if (start_cycles == 0) {
             /* Start timing after first token (prompt processing) */
-            start_cycles = ((uint64_t)SYS_CYCLE_HI << 32) | SYS_CYCLE_LO;
+            start_cycles = read_cycles();
+            /* The cycle counter starts when the CPU leaves reset (power-up
+             * or Reset Enter, before the slots load; see core_top.v) */
+            ttft_ms = (uint32_t)(start_cycles / CYCLES_PER_MS);
+            hud.start = start_cycles;
         }
+        hud.pos = pos;
+    }
+
+    /* Drain the console before anything else is printed */
+    console.stop = 1;
+    hud.stop = 1;
+    if (console.task > 0) {
+        coro_join(console.task);
+    }
+    if (hud_task > 0) {
+        coro_join(hud_task);
     }
     printf("\n");
 
     if (pos > 1 && start_cycles > 0) {
-        uint64_t end_cycles = ((uint64_t)SYS_CYCLE_HI << 32) | SYS_CYCLE_LO;
+        uint64_t end_cycles = read_cycles();
         uint64_t elapsed_cycles = end_cycles - start_cycles;
-        /* CPU runs at 50MHz, so cycles / 50000 = milliseconds */
-        uint32_t elapsed_ms = (uint32_t)(elapsed_cycles / 50000);
+        uint32_t elapsed_ms = (uint32_t)(elapsed_cycles / CYCLES_PER_MS);
         int tokens_generated = pos - 1;
         if (elapsed_ms > 0) {
             /* tokens per minute = tokens * 60000 / elapsed_ms */
             uint32_t tok_per_min = (uint32_t)((uint64_t)tokens_generated * 60000 / elapsed_ms);
             printf("Speed: %d tok/min (%d ms total)\n", tok_per_min, elapsed_ms);
         }
+        printf("First token %d ms after reset\n", ttft_ms);
     }
 
     free(prompt_tokens);
@@ -937,16 +1485,80 @@ static void generate(Transformer *transformer, Tokenizer *tokenizer, Sampler *sa
 #define HEAP_PSRAM_ADDR       0x30000000                  /* Heap in PSRAM (CRAM0) */
 #define HEAP_SIZE             (PSRAM_CACHE_ADDR - HEAP_PSRAM_ADDR)  /* 8MB for heap, upper 8MB for KV cache */
 
-void llama_main(void) {
-    printf("llama2.c for Analogue Pocket\n\n");
+/*
+ * Boot work that only needs BRAM and PSRAM, so it can run while the bridge is
+ * still streaming the data slots into SDRAM (sdram_arbiter shares the SDRAM
+ * port): PSRAM self-test and heap setup.
+ */
+static void boot_self_test(void) {
+    /* Test PSRAM write/read from CPU */
+    volatile uint32_t *test_addr = (volatile uint32_t *)HEAP_PSRAM_ADDR;
+    *test_addr = 0xDEADBEEF;
+    if (*test_addr != 0xDEADBEEF) {
+        printf("ERROR: PSRAM write failed!\n");
+        while(1);
+    }
+    heap_init((void*)HEAP_PSRAM_ADDR, HEAP_SIZE);
+    printf("PSRAM heap OK\n");
+}
+
+/* Build the tokenizer from the copy embedded in the firmware image (BRAM),
+ * before the tokenizer slot has arrived. Returns its vocabulary size. */
+static int build_tokenizer_embedded(Tokenizer* t) {
+    int vocab_size = tokenizer_vocab_size(tokenizer_bin, tokenizer_bin_len);
+    build_tokenizer_from_memory(t, tokenizer_bin, vocab_size);
+    return vocab_size;
+}
+
+/*
+ * Load progress on the current line while wait_for_model() polls: a
+ * coroutine (coro.h), so it only runs while the main task is waiting.
+ * Nothing is printed for loads shorter than LOAD_HUD_MS.
+ */
+#define LOAD_HUD_MS         250
+
+static void load_hud_task(void* arg) {
+    volatile int* stop = (volatile int*)arg;
+    uint32_t last = SYS_CYCLE_LO;
+    int shown = 0;
+    while (!*stop) {
+        if (SYS_CYCLE_LO - last >= LOAD_HUD_MS * CYCLES_PER_MS) {
+            last = SYS_CYCLE_LO;
+            printf("\rLoading... %u KB", SYS_ARB_BRIDGE_OPS / 256);
+            shown = 1;
+        }
+        coro_yield();
+    }
+    if (shown) {
+        printf("\n");
+    }
+}
+
+static int sysreg_status_set(void* arg) {
+    return (SYS_STATUS & (uint32_t)(uintptr_t)arg) != 0;
+}
+
+/* Wait for APF to load the data slots and sanity check the model header */
+static void wait_for_model(void) {
+    volatile int hud_stop = 0;
+    int hud = coro_spawn(load_hud_task, (void*)&hud_stop, hud_stack, sizeof(hud_stack));
 
     /* Wait for SDRAM and APF automatic data slot loading */
-    while (!(SYS_STATUS & SYS_STATUS_SDRAM_READY)) {}
+    coro_wait_until(sysreg_status_set, (void*)SYS_STATUS_SDRAM_READY);
     printf("SDRAM ready, waiting for data...\n");
 
     /* Wait for APF to finish auto-loading data slots */
-    while (!(SYS_STATUS & SYS_STATUS_DATASLOT_COMPLETE)) {}
-    printf("Data loaded\n");
+    coro_wait_until(sysreg_status_set, (void*)SYS_STATUS_DATASLOT_COMPLETE);
+    hud_stop = 1;
+    if (hud > 0) {
+        coro_join(hud);
+    }
+    printf("Data loaded (%u bridge words, at most %u queued)\n",
+           SYS_ARB_BRIDGE_OPS, SYS_ARB_BRIDGE_FIFO_MAX);
+    if (SYS_ARB_BRIDGE_OVERFLOW) {
+        printf("ERROR: bridge writes lost (arbiter FIFO overflow)\n");
+        while(1);
+    }
 
     /* Quick model sanity check */
     volatile uint32_t *model_header = (volatile uint32_t *)MODEL_SDRAM_ADDR;
@@ -956,16 +1568,22 @@ void llama_main(void) {
         while(1);
     }
     printf("Model check OK (dim=%d)\n", dim);
+}
 
-    /* Test PSRAM write/read from CPU */
-    volatile uint32_t *test_addr = (volatile uint32_t *)HEAP_PSRAM_ADDR;
-    *test_addr = 0xDEADBEEF;
-    if (*test_addr != 0xDEADBEEF) {
-        printf("ERROR: PSRAM write failed!\n");
-        while(1);
-    }
-    heap_init((void*)HEAP_PSRAM_ADDR, HEAP_SIZE);
-    printf("PSRAM heap OK\n");
+void llama_main(void) {
+    printf("llama2.c for Analogue Pocket\n\n");
+
+    /* Everything up to wait_for_model() overlaps the slot load: the CPU
+     * leaves reset on Reset Enter, not after the load (core_top.v) */
+    boot_self_test();
+    Tokenizer tokenizer;
+    int tok_vocab = build_tokenizer_embedded(&tokenizer);
+    uint32_t boot_cycles = SYS_CYCLE_LO;
+
+    wait_for_model();
+    uint32_t wait_cycles = SYS_CYCLE_LO - boot_cycles;
+    printf("Boot work %u ms, waited %u ms for data\n",
+           boot_cycles / CYCLES_PER_MS, wait_cycles / CYCLES_PER_MS);
 
     /* Build transformer from loaded data */
     Transformer transformer;
@@ -973,9 +1591,12 @@ void llama_main(void) {
     printf("Model: dim=%d layers=%d vocab=%d\n",
            transformer.config.dim, transformer.config.n_layers, transformer.config.vocab_size);
 
-    /* Build tokenizer from SDRAM */
-    Tokenizer tokenizer;
-    build_tokenizer_from_memory(&tokenizer, (void*)TOKENIZER_SDRAM_ADDR, transformer.config.vocab_size);
+    /* The embedded tokenizer only fits the bundled model; otherwise use the slot */
+    if (tok_vocab != transformer.config.vocab_size) {
+        free_tokenizer(&tokenizer);
+        check_slot_crc("Tokenizer", TOKENIZER_SLOT_ID, (const uint8_t*)TOKENIZER_SDRAM_ADDR, NULL);
+        build_tokenizer_from_memory(&tokenizer, (void*)TOKENIZER_SDRAM_ADDR, transformer.config.vocab_size);
+    }
     g_tokenizer = &tokenizer;
 
     /* Build sampler */
@@ -998,4 +1619,170 @@ void llama_main(void) {
 
     /* Halt */
     while(1);
-}
\ No newline at end of file
+}
+
+/* ============================================
+ * Benchmark entry point
+ * ============================================ */
+
+/*
+ * Prints machine-readable "BENCH key=value" lines for tools/cpu_matrix.py.
+ * Cycle counts come from SYS_CYCLE_LO (CPU clock), so results are directly
+ * comparable between VexRiscv configurations running at the same clock.
+ */
+#ifndef BENCH_TOKENS
+#define BENCH_TOKENS        16      /* forward() calls timed (greedy decode from BOS) */
+#endif
+#define BENCH_FLOAT_ITERS   256     /* iterations per soft-float micro-benchmark */
+#ifndef BENCH_ATTN_TOPK
+#define BENCH_ATTN_TOPK     32      /* approximate attention k for fwd_approx_pos*_cyc */
+#endif
+
+/* Attention-heavy positions. The decode continues through every earlier
+ * position first, so the KV cache and key shadow hold real keys: soft-float
+ * cost depends on the values, and top-k selection on the shadow. */
+static const int bench_positions[] = { 64, 128, 256, 511 };
+
+/* Operands are volatile so every iteration really calls into libgcc */
+static volatile float bench_fa = 1.2345f;
+static volatile float bench_fb = 0.9876f;
+static volatile float bench_fc;
+
+static uint32_t bench_float_op(int op) {
+    uint32_t start = SYS_CYCLE_LO;
+    for (int i = 0; i < BENCH_FLOAT_ITERS; i++) {
+        switch (op) {
+            case 0: bench_fc = bench_fa; break;                 /* loop overhead */
+            case 1: bench_fc = bench_fa + bench_fb; break;
+            case 2: bench_fc = bench_fa * bench_fb; break;
+            case 3: bench_fc = bench_fa / bench_fb; break;
+            case 4: bench_fc = expf(bench_fa); break;
+            default: bench_fc = sqrtf(bench_fa); break;
+        }
+    }
+    return SYS_CYCLE_LO - start;
+}
+
+void llama_bench(void) {
+    static const char* const op_names[] = { "fadd", "fmul", "fdiv", "expf", "sqrtf" };
+
+    printf("llama2.c benchmark\n\n");
+
+    /* Soft-float cost, loop overhead subtracted */
+    uint32_t overhead = bench_float_op(0);
+    for (int op = 1; op <= 5; op++) {
+        uint32_t cycles = bench_float_op(op) - overhead;
+        printf("BENCH %s_cyc=%u\n", op_names[op - 1], cycles / BENCH_FLOAT_ITERS);
+    }
+
+    /* Boot work that overlaps the slot load (see llama_main) */
+    boot_self_test();
+    Tokenizer tokenizer;
+    build_tokenizer_embedded(&tokenizer);
+    uint32_t boot_cycles = SYS_CYCLE_LO;
+
+    wait_for_model();
+    uint32_t loaded_cycles = SYS_CYCLE_LO;
+    printf("BENCH boot_cyc=%u\n", boot_cycles);
+    printf("BENCH load_wait_cyc=%u\n", loaded_cycles - boot_cycles);
+    printf("BENCH arb_share=%u\n", SYS_SDRAM_ARB);
+    printf("BENCH arb_cpu_ops=%u\n", SYS_ARB_CPU_OPS);
+    printf("BENCH arb_bridge_ops=%u\n", SYS_ARB_BRIDGE_OPS);
+    printf("BENCH arb_cpu_wait_cyc=%u\n", SYS_ARB_CPU_WAIT);
+    printf("BENCH arb_bridge_wait_cyc=%u\n", SYS_ARB_BRIDGE_WAIT);
+    printf("BENCH arb_bridge_fifo_max=%u\n", SYS_ARB_BRIDGE_FIFO_MAX);
+
+    Transformer transformer;
+    build_transformer_from_memory(&transformer, (void*)MODEL_SDRAM_ADDR, 0);
+    Config* p = &transformer.config;
+    printf("BENCH dim=%d hidden=%d layers=%d vocab=%d\n",
+           p->dim, p->hidden_dim, p->n_layers, p->vocab_size);
+#if QUANT_MATMUL
+    printf("BENCH quant=%d\n", transformer.weights.quantized);
+#else
+    printf("BENCH quant=0\n");
+#endif
+#ifdef BENCH_PLACEMENT_ONLY
+    /* tools/model_sweep.py --placement-only: the Placement line is all it needs */
+    printf("BENCH done\n");
+#ifdef SIM_CONSOLE
+    term_putchar(SIM_CONSOLE_EOT);
+#endif
+    while(1);
+#endif
+
+    int steps = BENCH_TOKENS < p->seq_len ? BENCH_TOKENS : p->seq_len;
+    int token = tokenizer.bos_id;
+    uint32_t first_cycles = 0;
+    uint32_t last_cycles = 0;
+    uint64_t total_cycles = 0;
+    for (int pos = 0; pos < steps; pos++) {
+        uint32_t start = SYS_CYCLE_LO;
+        float* logits = forward(&transformer, token, pos);
+        uint32_t cycles = SYS_CYCLE_LO - start;
+        if (pos == 0) {
+            first_cycles = cycles;
+            /* Cycle counter starts when the CPU leaves reset */
+            printf("BENCH ttft_cyc=%u\n", start + cycles);
+        }
+        last_cycles = cycles;
+        total_cycles += cycles;
+        token = sample_argmax(logits, p->vocab_size);
+    }
+
+    printf("BENCH tokens=%d\n", steps);
+    printf("BENCH fwd_first_cyc=%u\n", first_cycles);
+    printf("BENCH fwd_last_cyc=%u\n", last_cycles);
+    printf("BENCH fwd_avg_cyc=%u\n", (uint32_t)(total_cycles / steps));
+    printf("BENCH last_token=%d\n", token);
+
+    /* Each bench position is timed with exact attention, then again with
+     * approximate attention (attn.h): same token and position, so the second
+     * call rewrites the same KV cache and shadow entries. The positions in
+     * between are decoded with exact attention. */
+    RunState* rs = &transformer.state;
+    int exact_topk = rs->attn_topk;
+    int approx_topk = BENCH_ATTN_TOPK < ATTN_MAX_TOPK ? BENCH_ATTN_TOPK : ATTN_MAX_TOPK;
+    if (rs->key_shadow) {
+        printf("BENCH attn_topk=%d\n", approx_topk);
+        printf("BENCH attn_window=%d\n", ATTN_WINDOW);
+    }
+    int next = 0;
+    int n_positions = (int)(sizeof(bench_positions) / sizeof(bench_positions[0]));
+    while (next < n_positions && bench_positions[next] < steps) next++;
+    rs->attn_topk = 0;
+    for (int pos = steps; pos < p->seq_len && next < n_positions; pos++) {
+        if (bench_positions[next] > BENCH_MAX_POS) break;
+        if (pos < bench_positions[next]) {
+            token = sample_argmax(forward(&transformer, token, pos), p->vocab_size);
+            continue;
+        }
+        uint32_t start = SYS_CYCLE_LO;
+        uint32_t overlap = SYS_BUS_OVERLAP;
+        float* logits = forward(&transformer, token, pos);
+        uint32_t cycles = SYS_CYCLE_LO - start;
+        overlap = SYS_BUS_OVERLAP - overlap;
+        int exact_next = sample_argmax(logits, p->vocab_size);
+        printf("BENCH fwd_pos%d_cyc=%u\n", pos, cycles);
+        printf("BENCH fwd_pos%d_overlap_cyc=%u\n", pos, overlap);
+
+        if (rs->key_shadow) {
+            rs->attn_topk = approx_topk;
+            start = SYS_CYCLE_LO;
+            forward(&transformer, token, pos);
+            printf("BENCH fwd_approx_pos%d_cyc=%u\n", pos, SYS_CYCLE_LO - start);
+            rs->attn_topk = 0;
+        }
+        token = exact_next;
+        next++;
+    }
+    rs->attn_topk = exact_topk;
+    printf("BENCH done\n");
+
+    free_transformer(&transformer);
+    free_tokenizer(&tokenizer);
+#ifdef SIM_CONSOLE
+    term_putchar(SIM_CONSOLE_EOT);  /* stop the simulator */
+#endif
+    while(1);
+}
@@ -8,10 +8,16 @@
 /* External entry points */
 extern void llama_main(void);
 extern void memtest_main(void);
+extern void llama_bench(void);
 
 /* Set to 1 for memory test, 0 for llama */
 #define RUN_MEMTEST 0
 
+/* Set to 1 (or build with -DRUN_BENCH=1) for the forward() benchmark */
+#ifndef RUN_BENCH
+#define RUN_BENCH 0
+#endif
+
 int main(void) {
     term_init();
 
@@ -22,6 +28,9 @@ int main(void) {
 #if RUN_MEMTEST
     /* Run memory test suite */
     memtest_main();
+#elif RUN_BENCH
+    /* Time forward() and soft-float ops (see tools/cpu_matrix.py) */
+    llama_bench();
 #else
     /* Run Llama-2 inference */
     llama_main();
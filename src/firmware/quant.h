@@ -0,0 +1,120 @@
+/*
+ * Integer matmul for llama2.c: int8 weights x int16 activations
+ *
+ * Weights are quantized once (per-row absmax scale, int8), activations
+ * once per matmul input (one absmax scale for the whole vector, int16 or
+ * int8 range). The inner loop is then 32-bit integer mul/add only, with a
+ * single dequantize-and-scale per output element.
+ *
+ * Header-only so the same code runs in the firmware and in the host
+ * accuracy report (tools/quant_report.c).
+ */
+
+#ifndef QUANT_H
+#define QUANT_H
+
+#include <stdint.h>
+
+/* Activation ranges: int16 (default) or int8 */
+#define QUANT_ACT_MAX16     32767
+#define QUANT_ACT_MAX8      127
+
+/* MACs summed in int32 before folding into the float total:
+ * 256 * 32767 * 127 < 2^31, so no block can overflow */
+#define QUANT_BLOCK_WORDS   64
+
+/*
+ * Quantized weight matrix, row-major.
+ * Each row is n int8 values packed 4 per word (little-endian) and padded to
+ * a whole word: SDRAM and PSRAM only take word writes.
+ */
+typedef struct {
+    uint32_t* q;    /* rows * quant_row_words(n) words */
+    float*    s;    /* one scale per row */
+    int       n;    /* row length */
+} QuantTensor;
+
+/* Quantized activation vector, zero padded to a multiple of 4 */
+typedef struct {
+    int16_t* q;     /* quant_row_words(n) * 4 entries, byte-writable memory (BRAM) */
+    float    s;
+} QuantVec;
+
+static inline int quant_row_words(int n) {
+    return (n + 3) >> 2;
+}
+
+static inline int32_t quant_round(float v) {
+    return v >= 0.0f ? (int32_t)(v + 0.5f) : (int32_t)(v - 0.5f);
+}
+
+/* Quantize rows x n weights into t (q and s already allocated) */
+static void quantize_weights(QuantTensor* t, const float* w, int rows, int n) {
+    int words = quant_row_words(n);
+    t->n = n;
+    for (int r = 0; r < rows; r++) {
+        const float* wr = w + (long)r * n;
+        float amax = 0.0f;
+        for (int j = 0; j < n; j++) {
+            float a = wr[j] < 0.0f ? -wr[j] : wr[j];
+            if (a > amax) amax = a;
+        }
+        float scale = amax / 127.0f;
+        float inv = amax > 0.0f ? 127.0f / amax : 0.0f;
+        t->s[r] = scale;
+
+        uint32_t* qr = t->q + (long)r * words;
+        for (int k = 0; k < words; k++) {
+            uint32_t word = 0;
+            for (int b = 0; b < 4; b++) {
+                int j = k * 4 + b;
+                int32_t v = j < n ? quant_round(wr[j] * inv) : 0;
+                word |= (uint32_t)(v & 0xFF) << (b * 8);
+            }
+            qr[k] = word;
+        }
+    }
+}
+
+/* Quantize x[0..n) into v with one scale, values in [-qmax, qmax] */
+static void quantize_vec(QuantVec* v, const float* x, int n, int qmax) {
+    float amax = 0.0f;
+    for (int j = 0; j < n; j++) {
+        float a = x[j] < 0.0f ? -x[j] : x[j];
+        if (a > amax) amax = a;
+    }
+    float inv = amax > 0.0f ? (float)qmax / amax : 0.0f;
+    v->s = amax / (float)qmax;
+    for (int j = 0; j < n; j++) {
+        v->q[j] = (int16_t)quant_round(x[j] * inv);
+    }
+    for (int j = n; j < quant_row_words(n) * 4; j++) {
+        v->q[j] = 0;
+    }
+}
+
+/* xout[i] = row (row0 + i) of W . x, for i in [0, d) */
+static void matmul_q(float* xout, const QuantVec* x, const QuantTensor* w, int row0, int d) {
+    int words = quant_row_words(w->n);
+    for (int i = 0; i < d; i++) {
+        const uint32_t* wi = w->q + (long)(row0 + i) * words;
+        const int16_t* xq = x->q;
+        float val = 0.0f;
+        for (int k = 0; k < words; ) {
+            int end = k + QUANT_BLOCK_WORDS < words ? k + QUANT_BLOCK_WORDS : words;
+            int32_t acc = 0;
+            for (; k < end; k++) {
+                uint32_t word = wi[k];
+                acc += (int32_t)(int8_t)word * xq[0];
+                acc += (int32_t)(int8_t)(word >> 8) * xq[1];
+                acc += (int32_t)(int8_t)(word >> 16) * xq[2];
+                acc += (int32_t)(int8_t)(word >> 24) * xq[3];
+                xq += 4;
+            }
+            val += (float)acc;
+        }
+        xout[i] = val * (w->s[row0 + i] * x->s);
+    }
+}
+
+#endif
@@ -10,9 +10,20 @@
 // Terminal memory-mapped address
 static volatile char *const terminal = (volatile char *)0x20000000;
 
+#ifdef SIM_CONSOLE
+// Character stream for the simulator (outside the 1200-byte VRAM)
+static volatile char *const sim_console = (volatile char *)SIM_CONSOLE_ADDR;
+#endif
+
 // Current cursor position (0 to TERM_SIZE-1)
 static int cursor_pos = 0;
 
+// First row that scrolls (1 while term_status() holds the top row)
+static int scroll_top = 0;
+
+// Column term_putchar() writes to on the status row, -1 outside term_status()
+static int status_col = -1;
+
 // Get row from position (avoid division)
 static int pos_to_row(int pos) {
     int row = 0;
@@ -34,7 +45,7 @@ static int pos_to_col(int pos) {
 // Scroll terminal up by one line
 static void term_scroll(void) {
     // Copy each line to the line above
-    for (int i = 0; i < TERM_SIZE - TERM_COLS; i++) {
+    for (int i = scroll_top * TERM_COLS; i < TERM_SIZE - TERM_COLS; i++) {
         terminal[i] = terminal[i + TERM_COLS];
     }
     // Clear the bottom line
@@ -68,6 +79,16 @@ int term_getpos(void) {
 }
 
 void term_putchar(char c) {
+    if (status_col >= 0) {
+        // Status row: printable characters only, cut at the row end
+        if (c >= 32 && c < 127 && status_col < TERM_COLS) {
+            terminal[status_col++] = c;
+        }
+        return;
+    }
+#ifdef SIM_CONSOLE
+    *sim_console = c;
+#endif
     if (c == '\n') {
         // Move to start of next line
         int row = pos_to_row(cursor_pos);
@@ -196,10 +217,7 @@ static void print_hex(uint32_t val, int uppercase) {
     }
 }
 
-void term_printf(const char *fmt, ...) {
-    va_list args;
-    va_start(args, fmt);
-
+static void term_vprintf(const char *fmt, va_list args) {
     while (*fmt) {
         if (*fmt == '%') {
             fmt++;
@@ -265,6 +283,31 @@ void term_printf(const char *fmt, ...) {
         }
         fmt++;
     }
+}
 
+void term_printf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    term_vprintf(fmt, args);
     va_end(args);
 }
+
+void term_status(const char *fmt, ...) {
+    va_list args;
+    scroll_top = 1;
+    if (cursor_pos < TERM_COLS) {
+        cursor_pos = TERM_COLS;
+    }
+    status_col = 0;
+    va_start(args, fmt);
+    term_vprintf(fmt, args);
+    va_end(args);
+    while (status_col < TERM_COLS) {
+        terminal[status_col++] = ' ';
+    }
+    status_col = -1;
+}
+
+void term_status_end(void) {
+    scroll_top = 0;
+}
@@ -14,6 +14,13 @@
 #define TERM_ROWS 30
 #define TERM_SIZE (TERM_COLS * TERM_ROWS)
 
+// Simulation console (build with -DSIM_CONSOLE for src/sim)
+// Every character passed to term_putchar() is also written to this address,
+// so the Verilator harness can stream output without decoding VRAM scrolling.
+// Writing SIM_CONSOLE_EOT ends the simulation.
+#define SIM_CONSOLE_ADDR 0x20001FFC
+#define SIM_CONSOLE_EOT  0x04
+
 // Initialize terminal (clear screen, reset cursor)
 void term_init(void);
 
@@ -39,6 +46,14 @@ void term_println(const char *s);
 // Supports: %d, %u, %x, %X, %s, %c, %%, and width specifiers for hex (e.g., %08X)
 void term_printf(const char *fmt, ...);
 
+// Status line: rewrite the top row with term_printf() syntax, padded with
+// spaces. The row stops scrolling until term_status_end(); its text is not
+// copied to the simulation console.
+void term_status(const char *fmt, ...);
+
+// Give the top row back to the scrolling text
+void term_status_end(void);
+
 // Write hex number (useful for debugging)
 void term_puthex(uint32_t val, int digits);
 
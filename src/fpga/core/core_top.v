@@ -274,7 +274,7 @@ psram_controller #(
     .CLOCK_SPEED(133.333333)  // 133 MHz CPU clock
 ) psram0 (
     .clk(clk_ram_controller),
-    .reset_n(reset_n),
+    .reset_n(cpu_reset_n),
 
     // CPU interface
     .word_rd(cpu_psram_rd),
@@ -313,10 +313,10 @@ assign cram1_ub_n = 1;
 assign cram1_lb_n = 1;
 
 // SDRAM word interface signals (directly matching io_sdram interface)
-reg             ram1_word_rd;
-reg             ram1_word_wr;
-reg     [23:0]  ram1_word_addr;
-reg     [31:0]  ram1_word_data;
+wire            ram1_word_rd;
+wire            ram1_word_wr;
+wire    [23:0]  ram1_word_addr;
+wire    [31:0]  ram1_word_data;
 wire    [31:0]  ram1_word_q;
 wire            ram1_word_busy;
 wire            ram1_word_q_valid;
@@ -331,6 +331,21 @@ wire [23:0] cpu_sdram_addr;
 wire [31:0] cpu_sdram_wdata;
 wire [31:0] cpu_sdram_rdata;
 wire        cpu_sdram_busy;
+wire        cpu_sdram_rdata_valid;
+
+// SDRAM arbiter control/status (cpu_system system registers)
+wire [4:0]  sdram_bridge_share;
+wire [31:0] sdram_arb_cpu_ops;
+wire [31:0] sdram_arb_bridge_ops;
+wire [31:0] sdram_arb_cpu_wait;
+wire [31:0] sdram_arb_bridge_wait;
+wire [31:0] sdram_arb_bridge_fifo_max;
+wire        sdram_arb_bridge_overflow;
+
+// Data slot CRC32 (dataslot_crc, cpu_system system registers)
+wire         sdram_bridge_word_wr;
+wire [127:0] slot_crc;
+wire [127:0] slot_crc_bytes;
 
 assign sram_a = 'h0;
 assign sram_dq = {16{1'bZ}};
@@ -346,7 +361,7 @@ assign vpll_feed = 1'bZ;
 
 
 // Bridge read data mux
-reg     [31:0]  ram1_bridge_rd_data;
+wire    [31:0]  ram1_bridge_rd_data;
 
 always @(*) begin
     casex(bridge_addr)
@@ -363,128 +378,42 @@ always @(*) begin
     endcase
 end
 
-// Synchronize bridge signals from clk_74a to clk_ram_controller
-reg [31:0] bridge_addr_captured;
-reg [31:0] bridge_wr_data_captured;
-reg bridge_sdram_wr, bridge_sdram_rd;
-reg [31:0] bridge_addr_ram_clk;
-reg [31:0] bridge_wr_data_ram_clk;
-reg bridge_wr_done, bridge_rd_done;  // Feedback to 74a domain
-reg bridge_wr_done_sync1, bridge_wr_done_sync2;
-reg bridge_rd_done_sync1, bridge_rd_done_sync2;
-
-// Capture bridge signals in clk_74a domain
-// IMPORTANT: Hold the captured values until the RAM controller has processed them
-// This prevents race conditions when multiple writes come quickly
-always @(posedge clk_74a) begin
-    // Synchronize done signals back from RAM controller clock
-    bridge_wr_done_sync1 <= bridge_wr_done;
-    bridge_wr_done_sync2 <= bridge_wr_done_sync1;
-    bridge_rd_done_sync1 <= bridge_rd_done;
-    bridge_rd_done_sync2 <= bridge_rd_done_sync1;
-
-    // Clear the request when done is seen
-    if (bridge_wr_done_sync2) bridge_sdram_wr <= 0;
-    if (bridge_rd_done_sync2) bridge_sdram_rd <= 0;
-
-    // Only accept new requests when not busy
-    if (!bridge_sdram_wr && bridge_wr) begin
-        casex(bridge_addr[31:24])
-        8'b000000xx: begin
-            bridge_sdram_wr <= 1;
-            bridge_addr_captured <= bridge_addr;
-            bridge_wr_data_captured <= bridge_wr_data;
-        end
-        endcase
-    end
-    if (!bridge_sdram_rd && bridge_rd) begin
-        casex(bridge_addr[31:24])
-        8'b000000xx: begin
-            bridge_sdram_rd <= 1;
-            bridge_addr_captured <= bridge_addr;
-            ram1_bridge_rd_data <= ram1_word_q;  // Capture for bridge read (pipelined)
-        end
-        endcase
-    end
-end
-
-// 4-stage synchronizer for control signals + data capture
-// sync1 -> sync2 -> sync3 -> sync4 gives data plenty of time to stabilize
-reg bridge_wr_sync1, bridge_wr_sync2, bridge_wr_sync3, bridge_wr_sync4;
-reg bridge_rd_sync1, bridge_rd_sync2, bridge_rd_sync3, bridge_rd_sync4;
-
-always @(posedge clk_ram_controller) begin
-    // 4-stage sync for control signals
-    bridge_wr_sync1 <= bridge_sdram_wr;
-    bridge_wr_sync2 <= bridge_wr_sync1;
-    bridge_wr_sync3 <= bridge_wr_sync2;
-    bridge_wr_sync4 <= bridge_wr_sync3;
-    bridge_rd_sync1 <= bridge_sdram_rd;
-    bridge_rd_sync2 <= bridge_rd_sync1;
-    bridge_rd_sync3 <= bridge_rd_sync2;
-    bridge_rd_sync4 <= bridge_rd_sync3;
-
-    // Capture address/data on sync3 rising edge (when sync3 goes high but sync4 still low)
-    // By this point, data has been stable for 3 cycles in the fast clock domain
-    if (bridge_wr_sync3 && !bridge_wr_sync4) begin
-        bridge_addr_ram_clk <= bridge_addr_captured;
-        bridge_wr_data_ram_clk <= bridge_wr_data_captured;
-    end
-    if (bridge_rd_sync3 && !bridge_rd_sync4) begin
-        bridge_addr_ram_clk <= bridge_addr_captured;
-    end
-
-    // Signal done on sync4 rising edge - AFTER data has been captured and used
-    if (bridge_wr_sync4 && !bridge_wr_done) begin
-        bridge_wr_done <= 1;
-    end
-    if (bridge_rd_sync4 && !bridge_rd_done) begin
-        bridge_rd_done <= 1;
-    end
-
-    // Clear done when sync goes low
-    if (!bridge_wr_sync1) bridge_wr_done <= 0;
-    if (!bridge_rd_sync1) bridge_rd_done <= 0;
-end
-
-// Bridge is active from sync3 through done (when we're processing)
-wire bridge_wr_active = bridge_wr_sync3 | bridge_wr_sync4 | bridge_wr_done;
-wire bridge_rd_active = bridge_rd_sync3 | bridge_rd_sync4 | bridge_rd_done;
-
-// SDRAM access arbiter - runs at SDRAM controller clock (133 MHz)
-// Bridge has priority, CPU runs when bridge is idle
-always @(posedge clk_ram_controller) begin
-    ram1_word_rd <= 0;
-    ram1_word_wr <= 0;
-
-    // Issue SDRAM command on sync4 rising edge
-    // Data was captured on sync3->sync4 edge, so it's now stable in bridge_*_ram_clk
-    if (bridge_wr_sync4 && !bridge_wr_done) begin
-        // Bridge write - data is now stable in bridge_addr_ram_clk
-        ram1_word_wr <= 1;
-        ram1_word_addr <= bridge_addr_ram_clk[25:2];
-        ram1_word_data <= bridge_wr_data_ram_clk;
-    end else if (bridge_rd_sync4 && !bridge_rd_done) begin
-        // Bridge read - data is now stable in bridge_addr_ram_clk
-        ram1_word_rd <= 1;
-        ram1_word_addr <= bridge_addr_ram_clk[25:2];
-    end else if (!bridge_wr_active && !bridge_rd_active) begin
-        // CPU SDRAM access - same clock domain, direct connection
-        if (cpu_sdram_rd) begin
-            ram1_word_rd <= 1;
-            ram1_word_addr <= cpu_sdram_addr;
-        end
-        if (cpu_sdram_wr) begin
-            ram1_word_wr <= 1;
-            ram1_word_addr <= cpu_sdram_addr;
-            ram1_word_data <= cpu_sdram_wdata;
-        end
-    end
-end
-
-// CPU reads SDRAM data - direct connection (same clock domain)
-assign cpu_sdram_rdata = ram1_word_q;
-assign cpu_sdram_busy = ram1_word_busy;
+// Bridge <-> SDRAM CDC and CPU/bridge arbitration (see sdram_arbiter.v)
+sdram_arbiter sdram_arb (
+    .clk_74a(clk_74a),
+    .clk(clk_ram_controller),
+    .bridge_share(sdram_bridge_share),
+    // APF bridge
+    .bridge_addr(bridge_addr),
+    .bridge_rd(bridge_rd),
+    .bridge_wr(bridge_wr),
+    .bridge_wr_data(bridge_wr_data),
+    .bridge_rd_data(ram1_bridge_rd_data),
+    // CPU
+    .cpu_rd(cpu_sdram_rd),
+    .cpu_wr(cpu_sdram_wr),
+    .cpu_addr(cpu_sdram_addr),
+    .cpu_wdata(cpu_sdram_wdata),
+    .cpu_rdata(cpu_sdram_rdata),
+    .cpu_busy(cpu_sdram_busy),
+    .cpu_rdata_valid(cpu_sdram_rdata_valid),
+    // io_sdram word interface
+    .word_rd(ram1_word_rd),
+    .word_wr(ram1_word_wr),
+    .word_addr(ram1_word_addr),
+    .word_data(ram1_word_data),
+    .word_q(ram1_word_q),
+    .word_busy(ram1_word_busy),
+    .word_q_valid(ram1_word_q_valid),
+    .bridge_word_wr(sdram_bridge_word_wr),
+    // Status counters
+    .stat_cpu_ops(sdram_arb_cpu_ops),
+    .stat_bridge_ops(sdram_arb_bridge_ops),
+    .stat_cpu_wait(sdram_arb_cpu_wait),
+    .stat_bridge_wait(sdram_arb_bridge_wait),
+    .stat_bridge_fifo_max(sdram_arb_bridge_fifo_max),
+    .stat_bridge_fifo_overflow(sdram_arb_bridge_overflow)
+);
 
 
 //
@@ -651,6 +580,20 @@ core_bridge_cmd icb (
 
 );
 
+// CRC32 of each data slot as its words are written to SDRAM (see dataslot_crc.v)
+dataslot_crc dslot_crc (
+    .clk_74a(clk_74a),
+    .clk(clk_ram_controller),
+    .dataslot_requestwrite(dataslot_requestwrite),
+    .dataslot_requestwrite_id(dataslot_requestwrite_id),
+    .dataslot_requestwrite_size(dataslot_requestwrite_size),
+    .bridge_word_wr(sdram_bridge_word_wr),
+    .bridge_word_addr(ram1_word_addr),
+    .bridge_word_data(ram1_word_data),
+    .slot_crc(slot_crc),
+    .slot_bytes(slot_crc_bytes)
+);
+
 
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -708,6 +651,23 @@ assign video_hs = vidout_hs;
     reg         vidout_vs;
     reg         vidout_hs, vidout_hs_1;
     
+    // CPU reset, separate from the host reset_n: the host holds reset_n low
+    // from Reset Enter until Reset Exit, which it only sends once the data
+    // slots are loaded. The CPU, with its PSRAM and terminal ports, restarts
+    // on Reset Enter instead and runs through the load, so its boot work
+    // overlaps it; the firmware waits for the load in SYS_STATUS (cpu_system.v).
+    reg  [2:0]  cpu_host_reset_sync = 3'b111;
+    reg  [3:0]  cpu_reset_count = 4'hF;
+    wire        cpu_reset_n = cpu_reset_count == 4'h0;
+
+    always @(posedge clk_ram_controller) begin
+        cpu_host_reset_sync <= {cpu_host_reset_sync[1:0], reset_n};
+        if (!pll_core_locked || (cpu_host_reset_sync[2] && !cpu_host_reset_sync[1]))
+            cpu_reset_count <= 4'hF;
+        else if (cpu_reset_count != 4'h0)
+            cpu_reset_count <= cpu_reset_count - 4'h1;
+    end
+
     // CPU to terminal interface signals
     wire        term_mem_valid;
     wire [31:0] term_mem_addr;
@@ -719,9 +679,9 @@ assign video_hs = vidout_hs;
     // VexRiscv CPU system - run at 133 MHz (same as SDRAM controller, no CDC needed)
     cpu_system cpu (
         .clk(clk_ram_controller),  // 133 MHz - same as SDRAM controller
-        .clk_74a(clk_74a),
-        .reset_n(reset_n),
+        .reset_n(cpu_reset_n),
         .dataslot_allcomplete(dataslot_allcomplete),
+        .host_reset_n(reset_n),
         // Terminal interface
         .term_mem_valid(term_mem_valid),
         .term_mem_addr(term_mem_addr),
@@ -736,7 +696,18 @@ assign video_hs = vidout_hs;
         .sdram_wdata(cpu_sdram_wdata),
         .sdram_rdata(cpu_sdram_rdata),
         .sdram_busy(cpu_sdram_busy),
-        .sdram_rdata_valid(ram1_word_q_valid),
+        .sdram_rdata_valid(cpu_sdram_rdata_valid),
+        // SDRAM arbiter control/status
+        .sdram_bridge_share(sdram_bridge_share),
+        .sdram_arb_cpu_ops(sdram_arb_cpu_ops),
+        .sdram_arb_bridge_ops(sdram_arb_bridge_ops),
+        .sdram_arb_cpu_wait(sdram_arb_cpu_wait),
+        .sdram_arb_bridge_wait(sdram_arb_bridge_wait),
+        .sdram_arb_bridge_fifo_max(sdram_arb_bridge_fifo_max),
+        .sdram_arb_bridge_overflow(sdram_arb_bridge_overflow),
+        // Data slot CRC32
+        .slot_crc(slot_crc),
+        .slot_crc_bytes(slot_crc_bytes),
         // PSRAM interface (CRAM0)
         .psram_rd(cpu_psram_rd),
         .psram_wr(cpu_psram_wr),
@@ -752,7 +723,7 @@ assign video_hs = vidout_hs;
     text_terminal terminal (
         .clk(clk_core_12288),
         .clk_cpu(clk_ram_controller),  // CPU clock for memory interface (133 MHz)
-        .reset_n(reset_n),
+        .reset_n(cpu_reset_n),         // only resets the CPU memory interface
         .pixel_x(visible_x),
         .pixel_y(visible_y),
         .pixel_color(terminal_pixel_color),
@@ -884,7 +855,7 @@ end
 
     wire    pll_core_locked;
     wire    pll_core_locked_s;
-synch_3 s01(pll_core_locked, pll_core_locked_s, clk_74a);
+synch_3 s01(.i(pll_core_locked), .o(pll_core_locked_s), .clk(clk_74a), .rise(), .fall());
 
 mf_pllbase mp1 (
     .refclk         ( clk_74a ),
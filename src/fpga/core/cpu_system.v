@@ -5,16 +5,24 @@
 // - Memory-mapped terminal at 0x20000000
 // - SDRAM access at 0x10000000 (64MB)
 // - PSRAM access at 0x30000000 (16MB) - for heap
-// - System registers at 0x40000000
+// - System registers at 0x80000000 (bit 31: VexRiscv's uncached IO range)
+// - Split-transaction interconnect: instruction and data buses, SDRAM and
+//   PSRAM transactions proceed in parallel (SPLIT_BUS = 0: one transaction
+//   at a time, writes acked when done, for A/B benchmarks)
+// - SDRAM_BRIDGE_SHARE: reset value of the bridge/CPU SDRAM arbitration share
+//   (SYS_SDRAM_ARB, see sdram_arbiter.v)
 //
 
 `default_nettype none
 
-module cpu_system (
+module cpu_system #(
+    parameter SDRAM_BRIDGE_SHARE = 8, // Bridge grants per 16 when bridge and CPU contend
+    parameter SPLIT_BUS = 1           // 0: serialize all transactions (benchmark baseline)
+) (
     input wire clk,           // CPU clock (133 MHz - same as SDRAM controller)
-    input wire clk_74a,       // Bridge clock (74.25 MHz) - for APF interface
     input wire reset_n,
-    input wire dataslot_allcomplete,  // All data slots loaded by APF
+    input wire dataslot_allcomplete,  // All data slots loaded by APF (clk_74a)
+    input wire host_reset_n,          // Host reset from core_bridge_cmd (clk_74a), high after Reset Exit
 
     // Terminal memory interface
     output wire        term_mem_valid,
@@ -34,6 +42,19 @@ module cpu_system (
     input wire         sdram_busy,
     input wire         sdram_rdata_valid,  // Pulses when read data is valid
 
+    // SDRAM arbiter control and status (sdram_arbiter)
+    output reg  [4:0]  sdram_bridge_share,
+    input wire  [31:0] sdram_arb_cpu_ops,
+    input wire  [31:0] sdram_arb_bridge_ops,
+    input wire  [31:0] sdram_arb_cpu_wait,
+    input wire  [31:0] sdram_arb_bridge_wait,
+    input wire  [31:0] sdram_arb_bridge_fifo_max,
+    input wire         sdram_arb_bridge_overflow,
+
+    // Data slot CRC32, slots 0-3 (dataslot_crc)
+    input wire [127:0] slot_crc,
+    input wire [127:0] slot_crc_bytes,
+
     // PSRAM word interface (CRAM0 via core_top)
     output reg         psram_rd,
     output reg         psram_wr,
@@ -56,8 +77,6 @@ wire [29:0] ibus_adr;
 reg  [31:0] ibus_dat_miso;
 wire [31:0] ibus_dat_mosi;
 wire [3:0]  ibus_sel;
-wire [1:0]  ibus_bte;
-wire [2:0]  ibus_cti;
 
 // Data bus (Wishbone)
 wire        dbus_cyc;
@@ -68,8 +87,6 @@ wire [29:0] dbus_adr;
 reg  [31:0] dbus_dat_miso;
 wire [31:0] dbus_dat_mosi;
 wire [3:0]  dbus_sel;
-wire [1:0]  dbus_bte;
-wire [2:0]  dbus_cti;
 
 // Active-high reset for VexRiscv
 wire reset = ~reset_n;
@@ -97,8 +114,8 @@ VexRiscv cpu (
     .iBusWishbone_DAT_MOSI(ibus_dat_mosi),
     .iBusWishbone_SEL(ibus_sel),
     .iBusWishbone_ERR(1'b0),
-    .iBusWishbone_BTE(ibus_bte),
-    .iBusWishbone_CTI(ibus_cti),
+    .iBusWishbone_BTE(),         // Classic cycles only (see below)
+    .iBusWishbone_CTI(),
 
     // Data Wishbone bus
     .dBusWishbone_CYC(dbus_cyc),
@@ -110,50 +127,99 @@ VexRiscv cpu (
     .dBusWishbone_DAT_MOSI(dbus_dat_mosi),
     .dBusWishbone_SEL(dbus_sel),
     .dBusWishbone_ERR(1'b0),
-    .dBusWishbone_BTE(dbus_bte),
-    .dBusWishbone_CTI(dbus_cti)
+    .dBusWishbone_BTE(),
+    .dBusWishbone_CTI()
 );
 
 // ============================================
-// Arbitrated memory interface
+// Split-transaction interconnect
 // ============================================
-// Data bus has priority over instruction bus
-// Convert Wishbone to simple valid/ready protocol
-
-wire ibus_req = ibus_cyc & ibus_stb & ~ibus_ack;
-wire dbus_req = dbus_cyc & dbus_stb & ~dbus_ack;
-
-// Grant: data has priority
-wire dbus_grant = dbus_req;
-wire ibus_grant = ibus_req & ~dbus_req;
-
-// Muxed memory interface signals
-wire        mem_valid = dbus_grant | ibus_grant;
-wire [31:0] mem_addr  = dbus_grant ? {dbus_adr, 2'b00} : {ibus_adr, 2'b00};
-wire [31:0] mem_wdata = dbus_dat_mosi;
-wire [3:0]  mem_wstrb = dbus_grant ? (dbus_we ? dbus_sel : 4'b0) : 4'b0;
-wire        mem_write = dbus_grant & dbus_we;
+// The instruction and data buses are independent initiators: each request is
+// decoded on its own and handed to its target, so an I-cache refill can run
+// while a D-cache refill waits on SDRAM or PSRAM, and SDRAM and PSRAM work at
+// the same time.
+// - Each Wishbone bus has at most one outstanding request (classic cycles);
+//   ibus_busy/dbus_busy mark a bus that is waiting for its response
+// - SDRAM and PSRAM each have a request queue served in order, so responses
+//   come back in issue order per target
+// - SDRAM/PSRAM writes are posted: acked as soon as they are queued; a later
+//   access to the same memory queues behind them
+// - RAM, terminal and system registers are granted per cycle, data bus first
+// - With SPLIT_BUS = 0 a request is only taken while neither bus is waiting,
+//   the instruction bus only if the data bus is not asking, and writes hold
+//   their bus until done: one transaction in flight, like a single-master bus
 
 // Memory map:
 // 0x00000000 - 0x0000FFFF : RAM (64KB)
 // 0x10000000 - 0x13FFFFFF : SDRAM (64MB)
 // 0x20000000 - 0x20001FFF : Terminal VRAM
 // 0x30000000 - 0x30FFFFFF : PSRAM (16MB) - heap
-// 0x40000000 - 0x400000FF : System registers
-
-// Decode memory regions
-wire ram_select    = (mem_addr[31:16] == 16'b0);                    // 0x00000000-0x0000FFFF (64KB)
-wire sdram_select  = (mem_addr[31:26] == 6'b000100);                // 0x10000000-0x13FFFFFF (64MB)
-wire term_select   = (mem_addr[31:13] == 19'h10000);                // 0x20000000-0x20001FFF
-wire psram_select  = (mem_addr[31:24] == 8'h30);                    // 0x30000000-0x30FFFFFF (16MB)
-wire sysreg_select = (mem_addr[31:8] == 24'h400000);                // 0x40000000-0x400000FF
+// 0x80000000 - 0x800000FF : System registers (address bit 31 set: VexRiscv
+//                            bypasses its caches, so polled reads are fresh)
+
+localparam [2:0] RGN_NONE   = 3'd0;
+localparam [2:0] RGN_RAM    = 3'd1;
+localparam [2:0] RGN_SDRAM  = 3'd2;
+localparam [2:0] RGN_TERM   = 3'd3;
+localparam [2:0] RGN_PSRAM  = 3'd4;
+localparam [2:0] RGN_SYSREG = 3'd5;
+
+function [2:0] region;
+    input [31:0] addr;
+    begin
+        if (addr[31:16] == 16'b0)               region = RGN_RAM;     // 0x00000000-0x0000FFFF (64KB)
+        else if (addr[31:26] == 6'b000100)      region = RGN_SDRAM;   // 0x10000000-0x13FFFFFF (64MB)
+        else if (addr[31:13] == 19'h10000)      region = RGN_TERM;    // 0x20000000-0x20001FFF
+        else if (addr[31:24] == 8'h30)          region = RGN_PSRAM;   // 0x30000000-0x30FFFFFF (16MB)
+        else if (addr[31:8] == 24'h800000)      region = RGN_SYSREG;  // 0x80000000-0x800000FF
+        else                                    region = RGN_NONE;
+    end
+endfunction
+
+reg ibus_busy;
+reg dbus_busy;
+
+wire        serial_ok = SPLIT_BUS != 0 || (!ibus_busy && !dbus_busy);
+wire        dbus_req  = dbus_cyc & dbus_stb & ~dbus_ack & ~dbus_busy & serial_ok;
+wire        ibus_req  = ibus_cyc & ibus_stb & ~ibus_ack & ~ibus_busy & serial_ok &
+                        (SPLIT_BUS != 0 || !dbus_req);
+wire [31:0] ibus_addr = {ibus_adr, 2'b00};
+wire [31:0] dbus_addr = {dbus_adr, 2'b00};
+wire [2:0]  ibus_rgn  = region(ibus_addr);
+wire [2:0]  dbus_rgn  = region(dbus_addr);
+
+// Request queues: {dbus, we, word address, wdata}
+localparam QW  = 58;   // SDRAM: 24-bit word address
+localparam PQW = 56;   // PSRAM: 22-bit word address
+
+wire           sdq_full, sdq_empty;
+wire [QW-1:0]  sdq_head;
+wire           psq_full, psq_empty;
+wire [PQW-1:0] psq_head;
+
+reg term_active;
+
+// Grants (data bus first)
+wire dbus_ram_go  = dbus_req && dbus_rgn == RGN_RAM;
+wire ibus_ram_go  = ibus_req && ibus_rgn == RGN_RAM && !dbus_ram_go;
+wire dbus_sdq_go  = dbus_req && dbus_rgn == RGN_SDRAM && !sdq_full;
+wire ibus_sdq_go  = ibus_req && ibus_rgn == RGN_SDRAM && !sdq_full && !dbus_sdq_go;
+wire dbus_psq_go  = dbus_req && dbus_rgn == RGN_PSRAM && !psq_full;
+wire ibus_psq_go  = ibus_req && ibus_rgn == RGN_PSRAM && !psq_full && !dbus_psq_go;
+wire dbus_term_go = dbus_req && dbus_rgn == RGN_TERM && !term_active;
+wire ibus_term_go = ibus_req && ibus_rgn == RGN_TERM && !term_active && !dbus_term_go;
+wire dbus_reg_go  = dbus_req && (dbus_rgn == RGN_SYSREG || dbus_rgn == RGN_NONE);
+wire ibus_reg_go  = ibus_req && (ibus_rgn == RGN_SYSREG || ibus_rgn == RGN_NONE) && !dbus_reg_go;
 
 // ============================================
 // RAM using block RAM (64KB = 16384 x 32-bit words)
 // ============================================
+// One access per cycle, read data the cycle after the grant
 wire [31:0] ram_rdata;
-wire [13:0] ram_addr_mux = mem_addr[15:2];
-wire ram_wren = mem_valid && ram_select && |mem_wstrb;
+wire [13:0] ram_addr_mux = dbus_ram_go ? dbus_addr[15:2] : ibus_addr[15:2];
+wire [31:0] ram_wdata = dbus_ram_go ? dbus_dat_mosi : ibus_dat_mosi;
+wire [3:0]  ram_wstrb = dbus_ram_go ? dbus_sel : ibus_sel;
+wire ram_wren = (dbus_ram_go && dbus_we) || (ibus_ram_go && ibus_we);
 
 altsyncram #(
     .operation_mode("SINGLE_PORT"),
@@ -169,9 +235,9 @@ altsyncram #(
 ) ram (
     .clock0(clk),
     .address_a(ram_addr_mux),
-    .data_a(mem_wdata),
+    .data_a(ram_wdata),
     .wren_a(ram_wren),
-    .byteena_a(mem_wstrb),
+    .byteena_a(ram_wstrb),
     .q_a(ram_rdata),
     // Unused ports
     .aclr0(1'b0),
@@ -185,7 +251,7 @@ altsyncram #(
     .clocken1(1'b1),
     .clocken2(1'b1),
     .clocken3(1'b1),
-    .data_b({32{1'b0}}),
+    .data_b(1'b0),
     .eccstatus(),
     .q_b(),
     .rden_a(1'b1),
@@ -193,21 +259,38 @@ altsyncram #(
     .wren_b(1'b0)
 );
 
-// Forward terminal requests to terminal module
-assign term_mem_valid = mem_valid && term_select;
-assign term_mem_addr = mem_addr;
-assign term_mem_wdata = mem_wdata;
-assign term_mem_wstrb = mem_wstrb;
+// ============================================
+// Terminal (one transaction at a time)
+// ============================================
+reg        term_dbus;
+reg [31:0] term_addr;
+reg [31:0] term_wdata;
+reg [3:0]  term_wstrb;
+
+assign term_mem_valid = term_active;
+assign term_mem_addr = term_addr;
+assign term_mem_wdata = term_wdata;
+assign term_mem_wstrb = term_wstrb;
 
 // ============================================
 // System registers
 // ============================================
-// 0x00: SYS_STATUS   - Bit 0: always 1 (SDRAM ready), Bit 1: dataslot_allcomplete
-// 0x04: SYS_CYCLE_LO - Cycle counter low
-// 0x08: SYS_CYCLE_HI - Cycle counter high
+// 0x00: SYS_STATUS      - Bit 0: always 1 (SDRAM ready), Bit 1: data slots loaded since CPU reset
+// 0x04: SYS_CYCLE_LO    - Cycle counter low
+// 0x08: SYS_CYCLE_HI    - Cycle counter high
+// 0x0C: SYS_BUS_OVERLAP - Cycles with more than one memory transaction in flight
+// 0x10: SYS_SDRAM_ARB   - (R/W) Bits 4:0: bridge SDRAM grants per 16 when bridge and CPU contend
+// 0x14: SYS_ARB_CPU_OPS      - SDRAM word operations issued for the CPU
+// 0x18: SYS_ARB_BRIDGE_OPS   - SDRAM word operations issued for the bridge
+// 0x1C: SYS_ARB_CPU_WAIT     - Cycles CPU SDRAM requests waited for the arbiter
+// 0x20: SYS_ARB_BRIDGE_WAIT  - Cycles bridge SDRAM requests waited for the arbiter
+// 0x24: SYS_ARB_BRIDGE_FIFO_MAX - Most bridge writes queued in the arbiter at once
+// 0x28: SYS_ARB_BRIDGE_OVERFLOW - Bit 0: a bridge write found the arbiter FIFO full and was dropped (sticky)
+// The arbiter counters run from power-up (they also count the load before the CPU leaves reset)
 
 reg [31:0] sysreg_rdata;
 reg [63:0] cycle_counter;
+reg [31:0] overlap_counter;
 
 // Synchronize dataslot_allcomplete from bridge clock domain (clk_74a) to CPU clock domain
 reg [2:0] dataslot_allcomplete_sync;
@@ -216,45 +299,145 @@ always @(posedge clk) begin
 end
 wire dataslot_allcomplete_s = dataslot_allcomplete_sync[2];
 
+reg [2:0] host_reset_n_sync;
+always @(posedge clk) begin
+    host_reset_n_sync <= {host_reset_n_sync[1:0], host_reset_n};
+end
+wire host_running_s = host_reset_n_sync[2];
+
+// dataslot_allcomplete stays set from the previous load until the host
+// clears it with the first slot command of the next one, which comes after
+// Reset Enter has already restarted the CPU. A set flag only counts once it
+// has been seen clear since CPU reset, or once the host has left reset
+// (Reset Exit follows the load; it also covers a reset without a reload).
+reg allcomplete_stale;
+reg load_done;
+always @(posedge clk) begin
+    if (reset) begin
+        allcomplete_stale <= 1'b1;
+        load_done <= 1'b0;
+    end else begin
+        if (!dataslot_allcomplete_s || host_running_s)
+            allcomplete_stale <= 1'b0;
+        if (dataslot_allcomplete_s && !allcomplete_stale)
+            load_done <= 1'b1;
+    end
+end
+
+reg sdram_active;
+reg psram_active;
+reg ram_resp;
+wire [2:0] in_flight = {2'b0, sdram_active} + {2'b0, psram_active} + {2'b0, ram_resp} + {2'b0, term_active};
+
 always @(posedge clk) begin
     if (reset) begin
         cycle_counter <= 0;
+        overlap_counter <= 0;
     end else begin
         cycle_counter <= cycle_counter + 1;
+        if (in_flight > 3'd1) overlap_counter <= overlap_counter + 1;
     end
 end
 
+// SYS_SDRAM_ARB is the only writable register; shares above 16 mean 16
+always @(posedge clk) begin
+    if (reset) begin
+        sdram_bridge_share <= SDRAM_BRIDGE_SHARE[4:0];
+    end else if (dbus_reg_go && dbus_we && dbus_rgn == RGN_SYSREG && dbus_addr[7:2] == 6'b000100) begin
+        sdram_bridge_share <= dbus_dat_mosi[4] ? 5'd16 : dbus_dat_mosi[4:0];
+    end
+end
+
+wire [5:0] reg_index = dbus_reg_go ? dbus_addr[7:2] : ibus_addr[7:2];
+
 always @(*) begin
-    case (mem_addr[7:2])
-        6'b000000: sysreg_rdata = {30'b0, dataslot_allcomplete_s, 1'b1};  // SYS_STATUS
+    case (reg_index)
+        6'b000000: sysreg_rdata = {30'b0, load_done, 1'b1};  // SYS_STATUS
         6'b000001: sysreg_rdata = cycle_counter[31:0];   // SYS_CYCLE_LO
         6'b000010: sysreg_rdata = cycle_counter[63:32];  // SYS_CYCLE_HI
+        6'b000011: sysreg_rdata = overlap_counter;       // SYS_BUS_OVERLAP
+        6'b000100: sysreg_rdata = {27'b0, sdram_bridge_share};  // SYS_SDRAM_ARB
+        6'b000101: sysreg_rdata = sdram_arb_cpu_ops;       // SYS_ARB_CPU_OPS
+        6'b000110: sysreg_rdata = sdram_arb_bridge_ops;    // SYS_ARB_BRIDGE_OPS
+        6'b000111: sysreg_rdata = sdram_arb_cpu_wait;      // SYS_ARB_CPU_WAIT
+        6'b001000: sysreg_rdata = sdram_arb_bridge_wait;   // SYS_ARB_BRIDGE_WAIT
+        6'b001001: sysreg_rdata = sdram_arb_bridge_fifo_max;  // SYS_ARB_BRIDGE_FIFO_MAX
+        6'b001010: sysreg_rdata = {31'b0, sdram_arb_bridge_overflow};  // SYS_ARB_BRIDGE_OVERFLOW
+        6'b001100: sysreg_rdata = slot_crc[31:0];          // SYS_SLOT_CRC(0)
+        6'b001101: sysreg_rdata = slot_crc[63:32];         // SYS_SLOT_CRC(1)
+        6'b001110: sysreg_rdata = slot_crc[95:64];         // SYS_SLOT_CRC(2)
+        6'b001111: sysreg_rdata = slot_crc[127:96];        // SYS_SLOT_CRC(3)
+        6'b010000: sysreg_rdata = slot_crc_bytes[31:0];    // SYS_SLOT_CRC_BYTES(0)
+        6'b010001: sysreg_rdata = slot_crc_bytes[63:32];   // SYS_SLOT_CRC_BYTES(1)
+        6'b010010: sysreg_rdata = slot_crc_bytes[95:64];   // SYS_SLOT_CRC_BYTES(2)
+        6'b010011: sysreg_rdata = slot_crc_bytes[127:96];  // SYS_SLOT_CRC_BYTES(3)
         default: sysreg_rdata = 32'h0;
     endcase
 end
 
 // ============================================
-// Memory access state machine
+// SDRAM / PSRAM request queues
 // ============================================
-// Handle RAM, SDRAM, terminal, and sysreg accesses
-// Generate Wishbone ACK when complete
-
-reg mem_pending;
-reg [1:0] pending_bus;  // 0=none, 1=ibus, 2=dbus
-reg ram_pending;
-reg term_pending;
-reg sdram_read_pending;
-reg sdram_write_pending;
-reg sdram_write_started;
-reg psram_read_pending;
-reg psram_write_pending;
+wire sdq_push = dbus_sdq_go | ibus_sdq_go;
+wire psq_push = dbus_psq_go | ibus_psq_go;
+wire [QW-1:0] sdq_din = dbus_sdq_go ? {1'b1, dbus_we, dbus_addr[25:2], dbus_dat_mosi}
+                                    : {1'b0, ibus_we, ibus_addr[25:2], ibus_dat_mosi};
+wire [PQW-1:0] psq_din = dbus_psq_go ? {1'b1, dbus_we, dbus_addr[23:2], dbus_dat_mosi}
+                                     : {1'b0, ibus_we, ibus_addr[23:2], ibus_dat_mosi};
+
+// Head of each queue is in service while *_active; popped when it completes
+reg sdram_started;
 reg psram_started;
-reg sysreg_pending;
-reg [31:0] pending_rdata;
+wire sdq_head_we = sdq_head[56];
+wire sdq_pop = sdram_active && (sdq_head_we ? (sdram_started && !sdram_busy) : sdram_rdata_valid);
+wire psq_pop = psram_active && psram_started && !psram_busy;
+
+cpu_bus_queue #(.WIDTH(QW)) sdram_queue (
+    .clk(clk),
+    .reset(reset),
+    .push(sdq_push),
+    .din(sdq_din),
+    .full(sdq_full),
+    .pop(sdq_pop),
+    .dout(sdq_head),
+    .empty(sdq_empty)
+);
 
-localparam BUS_NONE = 2'd0;
-localparam BUS_IBUS = 2'd1;
-localparam BUS_DBUS = 2'd2;
+cpu_bus_queue #(.WIDTH(PQW)) psram_queue (
+    .clk(clk),
+    .reset(reset),
+    .push(psq_push),
+    .din(psq_din),
+    .full(psq_full),
+    .pop(psq_pop),
+    .dout(psq_head),
+    .empty(psq_empty)
+);
+
+// ============================================
+// Transaction engine
+// ============================================
+// Issues queue heads to the SDRAM/PSRAM controllers, completes RAM/terminal/
+// sysreg accesses and routes every response back to the bus that asked.
+
+reg ram_resp_dbus;
+
+// Ack a bus with read data and end its outstanding request
+task respond;
+    input        to_dbus;
+    input [31:0] data;
+    begin
+        if (to_dbus) begin
+            dbus_ack <= 1;
+            dbus_dat_miso <= data;
+            dbus_busy <= 0;
+        end else begin
+            ibus_ack <= 1;
+            ibus_dat_miso <= data;
+            ibus_busy <= 0;
+        end
+    end
+endtask
 
 always @(posedge clk or posedge reset) begin
     if (reset) begin
@@ -262,17 +445,19 @@ always @(posedge clk or posedge reset) begin
         dbus_ack <= 0;
         ibus_dat_miso <= 0;
         dbus_dat_miso <= 0;
-        mem_pending <= 0;
-        pending_bus <= BUS_NONE;
-        ram_pending <= 0;
-        term_pending <= 0;
-        sdram_read_pending <= 0;
-        sdram_write_pending <= 0;
-        sdram_write_started <= 0;
-        psram_read_pending <= 0;
-        psram_write_pending <= 0;
+        ibus_busy <= 0;
+        dbus_busy <= 0;
+        ram_resp <= 0;
+        ram_resp_dbus <= 0;
+        term_active <= 0;
+        term_dbus <= 0;
+        term_addr <= 0;
+        term_wdata <= 0;
+        term_wstrb <= 0;
+        sdram_active <= 0;
+        sdram_started <= 0;
+        psram_active <= 0;
         psram_started <= 0;
-        sysreg_pending <= 0;
         sdram_rd <= 0;
         sdram_wr <= 0;
         sdram_addr <= 0;
@@ -281,7 +466,6 @@ always @(posedge clk or posedge reset) begin
         psram_wr <= 0;
         psram_addr <= 0;
         psram_wdata <= 0;
-        pending_rdata <= 0;
     end else begin
         // Default: deassert ACKs and single-cycle signals
         ibus_ack <= 0;
@@ -291,141 +475,137 @@ always @(posedge clk or posedge reset) begin
         psram_rd <= 0;
         psram_wr <= 0;
 
-        if (!mem_pending && mem_valid) begin
-            // Start new memory access
-            pending_bus <= dbus_grant ? BUS_DBUS : BUS_IBUS;
-
-            if (ram_select) begin
-                mem_pending <= 1;
-                ram_pending <= 1;
-            end else if (sdram_select) begin
-                sdram_addr <= mem_addr[25:2];
-                if (mem_write) begin
-                    sdram_wr <= 1;
-                    sdram_wdata <= mem_wdata;
-                    mem_pending <= 1;
-                    sdram_write_pending <= 1;
-                    sdram_write_started <= 0;
-                end else begin
-                    sdram_rd <= 1;
-                    mem_pending <= 1;
-                    sdram_read_pending <= 1;
-                end
-            end else if (psram_select) begin
-                psram_addr <= mem_addr[23:2];  // Word address within PSRAM
-                if (mem_write) begin
-                    psram_wr <= 1;
-                    psram_wdata <= mem_wdata;
-                    mem_pending <= 1;
-                    psram_write_pending <= 1;
-                    psram_started <= 0;
-                end else begin
-                    psram_rd <= 1;
-                    mem_pending <= 1;
-                    psram_read_pending <= 1;
-                    psram_started <= 0;
-                end
-            end else if (term_select) begin
-                mem_pending <= 1;
-                term_pending <= 1;
-            end else if (sysreg_select) begin
-                mem_pending <= 1;
-                sysreg_pending <= 1;
-            end else begin
-                // Unknown region - return 0 immediately
-                if (dbus_grant) begin
-                    dbus_ack <= 1;
-                    dbus_dat_miso <= 32'h0;
-                end else begin
-                    ibus_ack <= 1;
-                    ibus_dat_miso <= 32'h0;
-                end
+        // ---- Accept requests ----
+        // RAM: read data is valid next cycle
+        ram_resp <= dbus_ram_go | ibus_ram_go;
+        ram_resp_dbus <= dbus_ram_go;
+        if (dbus_ram_go) dbus_busy <= 1;
+        if (ibus_ram_go) ibus_busy <= 1;
+
+        // SDRAM/PSRAM: reads wait for their response, writes are posted
+        if (dbus_sdq_go || dbus_psq_go) begin
+            if (dbus_we && SPLIT_BUS != 0) dbus_ack <= 1;
+            else dbus_busy <= 1;
+        end
+        if (ibus_sdq_go || ibus_psq_go) begin
+            if (ibus_we && SPLIT_BUS != 0) ibus_ack <= 1;
+            else ibus_busy <= 1;
+        end
+
+        // Terminal
+        if (dbus_term_go || ibus_term_go) begin
+            term_active <= 1;
+            term_dbus <= dbus_term_go;
+            term_addr <= dbus_term_go ? dbus_addr : ibus_addr;
+            term_wdata <= dbus_term_go ? dbus_dat_mosi : ibus_dat_mosi;
+            term_wstrb <= dbus_term_go ? (dbus_we ? dbus_sel : 4'b0) : (ibus_we ? ibus_sel : 4'b0);
+            if (dbus_term_go) dbus_busy <= 1;
+            else ibus_busy <= 1;
+        end
+
+        // System registers and unmapped addresses answer immediately
+        if (dbus_reg_go) begin
+            dbus_ack <= 1;
+            dbus_dat_miso <= dbus_rgn == RGN_SYSREG ? sysreg_rdata : 32'h0;
+        end else if (ibus_reg_go) begin
+            ibus_ack <= 1;
+            ibus_dat_miso <= ibus_rgn == RGN_SYSREG ? sysreg_rdata : 32'h0;
+        end
+
+        // ---- Complete transactions ----
+        if (ram_resp) begin
+            respond(ram_resp_dbus, ram_rdata);
+        end
+
+        if (term_active && term_mem_ready) begin
+            respond(term_dbus, term_mem_rdata);
+            term_active <= 0;
+        end
+
+        // SDRAM: issue the queue head, then wait for read data or write done
+        if (!sdram_active && !sdq_empty) begin
+            sdram_active <= 1;
+            sdram_started <= 0;
+            sdram_addr <= sdq_head[55:32];
+            sdram_wdata <= sdq_head[31:0];
+            if (sdq_head_we) sdram_wr <= 1;
+            else sdram_rd <= 1;
+        end else if (sdram_active) begin
+            // Write: wait for busy HIGH then LOW
+            if (sdq_head_we && !sdram_started && sdram_busy) begin
+                sdram_started <= 1;
             end
-        end else if (mem_pending) begin
-            // Complete pending access
-            if (ram_pending) begin
-                pending_rdata <= ram_rdata;
-                if (pending_bus == BUS_DBUS) begin
-                    dbus_ack <= 1;
-                    dbus_dat_miso <= ram_rdata;
-                end else begin
-                    ibus_ack <= 1;
-                    ibus_dat_miso <= ram_rdata;
-                end
-                mem_pending <= 0;
-                ram_pending <= 0;
-                pending_bus <= BUS_NONE;
-            end else if (sdram_read_pending && sdram_rdata_valid) begin
-                pending_rdata <= sdram_rdata;
-                if (pending_bus == BUS_DBUS) begin
-                    dbus_ack <= 1;
-                    dbus_dat_miso <= sdram_rdata;
-                end else begin
-                    ibus_ack <= 1;
-                    ibus_dat_miso <= sdram_rdata;
-                end
-                mem_pending <= 0;
-                sdram_read_pending <= 0;
-                pending_bus <= BUS_NONE;
-            end else if (sdram_write_pending) begin
-                // Write: wait for busy HIGH then LOW
-                if (!sdram_write_started && sdram_busy) begin
-                    sdram_write_started <= 1;
-                end else if (sdram_write_started && !sdram_busy) begin
-                    if (pending_bus == BUS_DBUS) begin
-                        dbus_ack <= 1;
-                        dbus_dat_miso <= 32'h0;
-                    end else begin
-                        ibus_ack <= 1;
-                        ibus_dat_miso <= 32'h0;
-                    end
-                    mem_pending <= 0;
-                    sdram_write_pending <= 0;
-                    sdram_write_started <= 0;
-                    pending_bus <= BUS_NONE;
-                end
-            end else if (psram_read_pending || psram_write_pending) begin
-                // PSRAM: wait for busy HIGH then LOW (same pattern as SDRAM write)
-                if (!psram_started && psram_busy) begin
-                    psram_started <= 1;
-                end else if (psram_started && !psram_busy) begin
-                    if (pending_bus == BUS_DBUS) begin
-                        dbus_ack <= 1;
-                        dbus_dat_miso <= psram_read_pending ? psram_rdata : 32'h0;
-                    end else begin
-                        ibus_ack <= 1;
-                        ibus_dat_miso <= psram_read_pending ? psram_rdata : 32'h0;
-                    end
-                    mem_pending <= 0;
-                    psram_read_pending <= 0;
-                    psram_write_pending <= 0;
-                    psram_started <= 0;
-                    pending_bus <= BUS_NONE;
-                end
-            end else if (term_pending && term_mem_ready) begin
-                if (pending_bus == BUS_DBUS) begin
-                    dbus_ack <= 1;
-                    dbus_dat_miso <= term_mem_rdata;
-                end else begin
-                    ibus_ack <= 1;
-                    ibus_dat_miso <= term_mem_rdata;
-                end
-                mem_pending <= 0;
-                term_pending <= 0;
-                pending_bus <= BUS_NONE;
-            end else if (sysreg_pending) begin
-                if (pending_bus == BUS_DBUS) begin
-                    dbus_ack <= 1;
-                    dbus_dat_miso <= sysreg_rdata;
-                end else begin
-                    ibus_ack <= 1;
-                    ibus_dat_miso <= sysreg_rdata;
-                end
-                mem_pending <= 0;
-                sysreg_pending <= 0;
-                pending_bus <= BUS_NONE;
+            if (sdq_pop) begin
+                if (!sdq_head_we || SPLIT_BUS == 0) respond(sdq_head[57], sdram_rdata);
+                sdram_active <= 0;
             end
         end
+
+        // PSRAM: same, busy HIGH then LOW for reads and writes
+        if (!psram_active && !psq_empty) begin
+            psram_active <= 1;
+            psram_started <= 0;
+            psram_addr <= psq_head[53:32];  // Word address within PSRAM
+            psram_wdata <= psq_head[31:0];
+            if (psq_head[54]) psram_wr <= 1;
+            else psram_rd <= 1;
+        end else if (psram_active) begin
+            if (!psram_started && psram_busy) begin
+                psram_started <= 1;
+            end
+            if (psq_pop) begin
+                if (!psq_head[54] || SPLIT_BUS == 0) respond(psq_head[55], psram_rdata);
+                psram_active <= 0;
+            end
+        end
+    end
+end
+
+endmodule
+
+// ============================================
+// In-order request queue for cpu_system
+// ============================================
+
+module cpu_bus_queue #(
+    parameter WIDTH = 58,
+    parameter DEPTH_LOG2 = 2
+) (
+    input wire              clk,
+    input wire              reset,
+    input wire              push,
+    input wire  [WIDTH-1:0] din,
+    output wire             full,
+    input wire              pop,
+    output wire [WIDTH-1:0] dout,
+    output wire             empty
+);
+
+reg [WIDTH-1:0]      entries [0:(1 << DEPTH_LOG2) - 1];
+reg [DEPTH_LOG2-1:0] wr_ptr;
+reg [DEPTH_LOG2-1:0] rd_ptr;
+reg [DEPTH_LOG2:0]   count;
+
+wire do_push = push && !full;
+wire do_pop = pop && !empty;
+
+assign full = count[DEPTH_LOG2];
+assign empty = (count == 0);
+assign dout = entries[rd_ptr];
+
+always @(posedge clk) begin
+    if (do_push) entries[wr_ptr] <= din;
+end
+
+always @(posedge clk or posedge reset) begin
+    if (reset) begin
+        wr_ptr <= 0;
+        rd_ptr <= 0;
+        count <= 0;
+    end else begin
+        if (do_push) wr_ptr <= wr_ptr + 1'b1;
+        if (do_pop) rd_ptr <= rd_ptr + 1'b1;
+        count <= count + {{DEPTH_LOG2{1'b0}}, do_push} - {{DEPTH_LOG2{1'b0}}, do_pop};
     end
 end
 
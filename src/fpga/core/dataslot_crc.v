@@ -0,0 +1,143 @@
+//
+// Data slot CRC32
+// - Hashes each data slot as the bridge writes land in SDRAM: fed with the
+//   words sdram_arbiter actually issues, so lost or corrupted words (bridge
+//   CDC) show up as a mismatch
+// - A slot starts with its Data Slot Request Write (0x0082, id + size from
+//   core_bridge_cmd) and ends after size bytes; only writes inside the slot's
+//   address range (SLOT_ADDR, as in data.json) are hashed, so later bridge
+//   writes (target data slot reads) and writes elsewhere are not
+// - CRC-32 as zlib/IEEE 802.3 (reflected, poly 0xEDB88320, init and final
+//   xor 0xFFFFFFFF) over the file bytes; bridge words are little-endian, so
+//   byte 0 of the file is bits 7:0
+// - One byte per clock: a word is taken into a shift register and hashed
+//   over the next 1-4 cycles. sdram_arbiter issues a word operation at most
+//   every 4 clk (grant, io_sdram busy, idle, grant), so the next word never
+//   arrives before the last byte of the previous one is hashed
+// - Slot ids 0-3 have a result register each: final CRC and bytes hashed
+//
+
+`default_nettype none
+
+module dataslot_crc #(
+    // Bridge byte address of slots 0-3, slot n in bits [32n+31:32n] (data.json)
+    parameter [127:0] SLOT_ADDR = {32'h00000000, 32'h00000000, 32'h03F00000, 32'h00000000}
+) (
+    input wire          clk_74a,
+    input wire          clk,            // SDRAM controller / CPU clock
+
+    // Slot start (core_bridge_cmd, clk_74a)
+    input wire          dataslot_requestwrite,
+    input wire  [15:0]  dataslot_requestwrite_id,
+    input wire  [31:0]  dataslot_requestwrite_size,
+
+    // Bridge words written to SDRAM (sdram_arbiter, clk)
+    input wire          bridge_word_wr,
+    input wire  [23:0]  bridge_word_addr,   // word address (bridge address bits 25:2)
+    input wire  [31:0]  bridge_word_data,
+
+    // Per slot results, slot n in bits [32n+31:32n] (clk)
+    output wire [127:0] slot_crc,
+    output wire [127:0] slot_bytes
+);
+
+// Reflected CRC-32 over one byte
+function [31:0] crc32_byte;
+    input [31:0] crc;
+    input [7:0]  data;
+    integer i;
+    reg [31:0] c;
+    begin
+        c = crc ^ {24'd0, data};
+        for (i = 0; i < 8; i = i + 1) begin
+            c = c[0] ? (c >> 1) ^ 32'hEDB88320 : c >> 1;
+        end
+        crc32_byte = c;
+    end
+endfunction
+
+// Latch the slot id/size in clk_74a and hand them over with a toggle; the
+// first data word follows the command by far more than the sync delay
+reg [15:0] start_id;
+reg [31:0] start_size;
+reg        start_toggle = 0;
+reg        requestwrite_last = 0;
+
+always @(posedge clk_74a) begin
+    requestwrite_last <= dataslot_requestwrite;
+    if (dataslot_requestwrite && !requestwrite_last) begin
+        start_id <= dataslot_requestwrite_id;
+        start_size <= dataslot_requestwrite_size;
+        start_toggle <= ~start_toggle;
+    end
+end
+
+reg [2:0]  start_sync = 0;
+reg [1:0]  cur_slot;
+reg        cur_valid = 0;       // slot id 0-3 and bytes left
+reg [31:0] remaining;
+reg [24:0] range_lo;            // slot word addresses [range_lo, range_hi)
+reg [24:0] range_hi;
+reg [31:0] crc_run;
+
+// Word being hashed, low byte first
+reg [31:0] pend_data;
+reg [2:0]  pend_bytes = 0;
+
+reg [31:0] crc_reg [0:3];
+reg [31:0] bytes_reg [0:3];
+
+integer n;
+initial begin
+    for (n = 0; n < 4; n = n + 1) begin
+        crc_reg[n] = 0;
+        bytes_reg[n] = 0;
+    end
+end
+
+wire [31:0] start_addr = SLOT_ADDR[{start_id[1:0], 5'd0} +: 32];
+wire [24:0] start_lo = {1'b0, start_addr[25:2]};
+wire        unused_start_addr = &{1'b0, start_addr[31:26], start_addr[1:0]};
+wire [24:0] start_words = start_size[26:2] + {24'd0, start_size[1:0] != 2'd0};
+wire        in_range = {1'b0, bridge_word_addr} >= range_lo && {1'b0, bridge_word_addr} < range_hi;
+
+wire [2:0]  word_bytes = remaining > 32'd3 ? 3'd4 : remaining[2:0];
+wire [31:0] word_bytes32 = {29'd0, word_bytes};
+wire [31:0] crc_next = crc32_byte(crc_run, pend_data[7:0]);
+
+always @(posedge clk) begin
+    start_sync <= {start_sync[1:0], start_toggle};
+
+    if (start_sync[2] != start_sync[1]) begin
+        cur_slot <= start_id[1:0];
+        cur_valid <= start_id < 16'd4 && start_size != 32'd0;
+        remaining <= start_size;
+        range_lo <= start_lo;
+        range_hi <= start_lo + start_words;
+        crc_run <= 32'hFFFFFFFF;
+        pend_bytes <= 3'd0;
+        if (start_id < 16'd4) begin
+            crc_reg[start_id[1:0]] <= 32'd0;
+            bytes_reg[start_id[1:0]] <= 32'd0;
+        end
+    end else begin
+        if (pend_bytes != 3'd0) begin
+            crc_run <= crc_next;
+            crc_reg[cur_slot] <= ~crc_next;
+            bytes_reg[cur_slot] <= bytes_reg[cur_slot] + 32'd1;
+            pend_data <= pend_data >> 8;
+            pend_bytes <= pend_bytes - 3'd1;
+        end
+        if (bridge_word_wr && cur_valid && in_range) begin
+            pend_data <= bridge_word_data;
+            pend_bytes <= word_bytes;
+            remaining <= remaining - word_bytes32;
+            if (remaining <= 32'd4) cur_valid <= 0;
+        end
+    end
+end
+
+assign slot_crc = {crc_reg[3], crc_reg[2], crc_reg[1], crc_reg[0]};
+assign slot_bytes = {bytes_reg[3], bytes_reg[2], bytes_reg[1], bytes_reg[0]};
+
+endmodule
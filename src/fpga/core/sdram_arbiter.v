@@ -0,0 +1,303 @@
+//
+// SDRAM access arbiter
+// - Bridge writes (0x00000000 - 0x03FFFFFF) cross from clk_74a into the SDRAM
+//   controller clock through an asynchronous FIFO; bridge reads use a 4-stage
+//   synchronizer + done feedback
+// - Shares the io_sdram word interface between the bridge and the CPU, so the
+//   CPU can keep running while data slots are streamed in
+// - Requests from both sides are held until granted; one word operation is
+//   in flight at a time
+// - When both sides are waiting, the bridge gets bridge_share out of every 16
+//   grants (credit accumulator, so the grants are interleaved):
+//   16 = bridge priority, 0 = CPU priority, 8 = round robin
+// - The bridge has no backpressure, so no bridge write is ever dropped: the
+//   APF bridge delivers at most one word per 88 clk_74a cycles (~160 clk),
+//   an SDRAM word operation takes ~30 clk at worst, and once the FIFO is half
+//   full the bridge wins every grant whatever bridge_share says. A CPU burst
+//   can then hold off one more operation, so the FIFO never goes past
+//   FIFO_DEPTH / 2 + 1 entries. Should the FIFO fill anyway, the write is
+//   dropped and stat_bridge_fifo_overflow stays set (SYS_ARB_BRIDGE_OVERFLOW).
+// - Status counters (free running, clk domain) for the CPU system registers
+//
+
+`default_nettype none
+
+module sdram_arbiter (
+    input wire         clk_74a,        // Bridge clock
+    input wire         clk,            // SDRAM controller / CPU clock (133 MHz)
+
+    // Arbitration control (clk)
+    input wire  [4:0]  bridge_share,   // Bridge grants per 16 when both sides wait (0-16)
+
+    // APF bridge (clk_74a)
+    input wire  [31:0] bridge_addr,
+    input wire         bridge_rd,
+    input wire         bridge_wr,
+    input wire  [31:0] bridge_wr_data,
+    output reg  [31:0] bridge_rd_data,
+
+    // CPU SDRAM interface (clk)
+    input wire         cpu_rd,
+    input wire         cpu_wr,
+    input wire  [23:0] cpu_addr,
+    input wire  [31:0] cpu_wdata,
+    output wire [31:0] cpu_rdata,
+    output wire        cpu_busy,
+    output wire        cpu_rdata_valid,
+
+    // io_sdram word interface (clk)
+    output reg         word_rd,
+    output reg         word_wr,
+    output reg  [23:0] word_addr,
+    output reg  [31:0] word_data,
+    input wire  [31:0] word_q,
+    input wire         word_busy,
+    input wire         word_q_valid,
+    output reg         bridge_word_wr,     // word_wr/word_data are a bridge write (dataslot_crc)
+
+    // Status counters (clk)
+    output reg  [31:0] stat_cpu_ops,       // CPU word operations issued
+    output reg  [31:0] stat_bridge_ops,    // Bridge word operations issued
+    output reg  [31:0] stat_cpu_wait,      // Cycles a CPU request waited for its grant
+    output reg  [31:0] stat_bridge_wait,   // Cycles a bridge request waited for its grant
+    output reg  [31:0] stat_bridge_fifo_max, // Most bridge writes queued at once
+    output reg         stat_bridge_fifo_overflow  // Sticky: a bridge write found the FIFO full and was dropped
+);
+
+// ============================================
+// Bridge write FIFO (clk_74a -> clk)
+// ============================================
+// {word address, data} per entry; Gray-coded pointers synchronized into the
+// other clock. The bridge cannot be stalled and the grant below keeps the
+// FIFO from filling (see the header); the full check on the write side only
+// catches that assumption failing. It uses the synchronized read pointer, so
+// it can see the FIFO full for a few cycles after the last slot was freed.
+localparam FIFO_AW    = 4;
+localparam FIFO_DEPTH = 1 << FIFO_AW;
+
+reg [55:0] fifo_mem [0:FIFO_DEPTH-1];
+
+// Bridge accesses are whole words
+wire unused_bridge_addr = &{1'b0, bridge_addr[1:0]};
+
+function [FIFO_AW:0] gray_to_bin;
+    input [FIFO_AW:0] g;
+    integer i;
+    begin
+        gray_to_bin[FIFO_AW] = g[FIFO_AW];
+        for (i = FIFO_AW - 1; i >= 0; i = i - 1) begin
+            gray_to_bin[i] = gray_to_bin[i + 1] ^ g[i];
+        end
+    end
+endfunction
+
+// Write side (clk_74a)
+reg [FIFO_AW:0] fifo_wr_bin = 0;
+reg [FIFO_AW:0] fifo_wr_gray = 0;
+wire [FIFO_AW:0] fifo_wr_bin_next = fifo_wr_bin + 1'b1;
+reg [FIFO_AW:0] fifo_rd_gray = 0;   // clk domain, next to fifo_rd_bin
+reg [FIFO_AW:0] fifo_rd_gray_sync1 = 0, fifo_rd_gray_sync2 = 0;
+wire [FIFO_AW:0] fifo_wr_level = fifo_wr_bin - gray_to_bin(fifo_rd_gray_sync2);
+wire            fifo_full = fifo_wr_level[FIFO_AW];
+reg             fifo_overflow = 0;
+
+always @(posedge clk_74a) begin
+    fifo_rd_gray_sync1 <= fifo_rd_gray;
+    fifo_rd_gray_sync2 <= fifo_rd_gray_sync1;
+
+    if (bridge_wr && bridge_addr[31:26] == 6'b000000) begin
+        if (fifo_full) begin
+            fifo_overflow <= 1;
+        end else begin
+            fifo_mem[fifo_wr_bin[FIFO_AW-1:0]] <= {bridge_addr[25:2], bridge_wr_data};
+            fifo_wr_bin <= fifo_wr_bin_next;
+            fifo_wr_gray <= fifo_wr_bin_next ^ (fifo_wr_bin_next >> 1);
+        end
+    end
+end
+
+// Read side (clk)
+reg  [FIFO_AW:0] fifo_wr_gray_sync1 = 0, fifo_wr_gray_sync2 = 0;
+reg  [FIFO_AW:0] fifo_rd_bin = 0;
+wire [FIFO_AW:0] fifo_rd_bin_next = fifo_rd_bin + 1'b1;
+reg              fifo_overflow_sync1 = 0;
+wire [FIFO_AW:0] fifo_level  = gray_to_bin(fifo_wr_gray_sync2) - fifo_rd_bin;
+wire             fifo_empty  = fifo_level == 0;
+wire             fifo_urgent = fifo_level[FIFO_AW:FIFO_AW-1] != 2'b00;    // half full or more
+wire [55:0]      fifo_head   = fifo_mem[fifo_rd_bin[FIFO_AW-1:0]];
+wire [31:0]      fifo_level32 = {{(31-FIFO_AW){1'b0}}, fifo_level};
+
+// ============================================
+// Bridge reads (clk_74a -> clk)
+// ============================================
+// Reads are buffered by one word (io_bridge_peripheral): each bridge read
+// returns the word fetched by the previous one and starts the next fetch
+reg [23:0] bridge_rd_addr_captured;  // Word address
+reg        bridge_sdram_rd = 0;
+reg        bridge_rd_done = 0;     // Feedback to 74a domain
+reg        bridge_rd_done_sync1 = 0, bridge_rd_done_sync2 = 0;
+reg [31:0] bridge_rd_word;         // Last bridge read result (clk)
+
+always @(posedge clk_74a) begin
+    // Synchronize done back from RAM controller clock; clear the request
+    bridge_rd_done_sync1 <= bridge_rd_done;
+    bridge_rd_done_sync2 <= bridge_rd_done_sync1;
+    if (bridge_rd_done_sync2) bridge_sdram_rd <= 0;
+
+    // Only accept new requests when not busy
+    if (!bridge_sdram_rd && bridge_rd && bridge_addr[31:26] == 6'b000000) begin
+        bridge_sdram_rd <= 1;
+        bridge_rd_addr_captured <= bridge_addr[25:2];
+        bridge_rd_data <= bridge_rd_word;  // Word fetched by the previous read
+    end
+end
+
+// 4-stage synchronizer for the read request + address capture
+// sync1 -> sync2 -> sync3 -> sync4 gives the address plenty of time to stabilize
+reg bridge_rd_sync1 = 0, bridge_rd_sync2 = 0, bridge_rd_sync3 = 0, bridge_rd_sync4 = 0;
+reg [23:0] bridge_rd_addr_ram_clk;
+
+always @(posedge clk) begin
+    bridge_rd_sync1 <= bridge_sdram_rd;
+    bridge_rd_sync2 <= bridge_rd_sync1;
+    bridge_rd_sync3 <= bridge_rd_sync2;
+    bridge_rd_sync4 <= bridge_rd_sync3;
+
+    // Capture the address on the sync3 rising edge; by then it has been
+    // stable for 3 cycles in the fast clock domain
+    if (bridge_rd_sync3 && !bridge_rd_sync4) begin
+        bridge_rd_addr_ram_clk <= bridge_rd_addr_captured;
+    end
+end
+
+// ============================================
+// Pending requests
+// ============================================
+// Bridge: queued writes, or a read once its address reaches this domain.
+// Writes go first, so a read waits for the writes issued before it.
+reg  bridge_pend_rd = 0;
+wire bridge_pend_wr = !fifo_empty;
+wire bridge_pend = bridge_pend_wr | bridge_pend_rd;
+
+// CPU: cpu_rd/cpu_wr are single-cycle pulses, address and data are held
+// here until the grant
+reg        cpu_pend_wr = 0, cpu_pend_rd = 0;
+reg [23:0] cpu_addr_held;
+reg [31:0] cpu_wdata_held;
+wire cpu_pend = cpu_pend_wr | cpu_pend_rd;
+
+// ============================================
+// Grant
+// ============================================
+// Word operation in flight; it is done once io_sdram has been busy and is idle again
+reg op_active = 0;
+reg op_started = 0;
+reg op_cpu = 0;
+reg op_read = 0;
+
+// Credit accumulator for contended grants: add bridge_share per grant, the
+// bridge wins when it crosses 16
+reg  [3:0] share_acc = 0;
+wire [5:0] share_next = {2'b00, share_acc} + {1'b0, bridge_share};
+wire       share_bridge = share_next[5:4] != 2'b00;
+wire       contended = bridge_pend && cpu_pend;
+
+wire grant_free   = !op_active;
+wire grant_bridge = grant_free && bridge_pend && (!cpu_pend || share_bridge || fifo_urgent);
+wire grant_cpu    = grant_free && cpu_pend && !grant_bridge;
+
+always @(posedge clk) begin
+    word_rd <= 0;
+    word_wr <= 0;
+    bridge_word_wr <= 0;
+
+    fifo_wr_gray_sync1 <= fifo_wr_gray;
+    fifo_wr_gray_sync2 <= fifo_wr_gray_sync1;
+    fifo_overflow_sync1 <= fifo_overflow;
+    stat_bridge_fifo_overflow <= fifo_overflow_sync1;
+
+    // Clear done when sync goes low
+    if (!bridge_rd_sync1) bridge_rd_done <= 0;
+
+    // Bridge read pending once its address is captured (sync3 edge)
+    if (bridge_rd_sync3 && !bridge_rd_sync4) bridge_pend_rd <= 1;
+    if (cpu_wr) begin
+        cpu_pend_wr <= 1;
+        cpu_addr_held <= cpu_addr;
+        cpu_wdata_held <= cpu_wdata;
+    end
+    if (cpu_rd) begin
+        cpu_pend_rd <= 1;
+        cpu_addr_held <= cpu_addr;
+    end
+
+    if (contended && grant_free) begin
+        share_acc <= share_next[3:0];  // wraps past 16 when the bridge wins
+    end
+
+    if (grant_bridge) begin
+        if (bridge_pend_wr) begin
+            word_wr <= 1;
+            word_addr <= fifo_head[55:32];
+            word_data <= fifo_head[31:0];
+            bridge_word_wr <= 1;
+            fifo_rd_bin <= fifo_rd_bin_next;
+            fifo_rd_gray <= fifo_rd_bin_next ^ (fifo_rd_bin_next >> 1);
+        end else begin
+            // Signal done at the grant, so clk_74a may accept the next read
+            word_rd <= 1;
+            word_addr <= bridge_rd_addr_ram_clk;
+            bridge_pend_rd <= 0;
+            bridge_rd_done <= 1;
+        end
+        op_cpu <= 0;
+        op_read <= !bridge_pend_wr;
+    end else if (grant_cpu) begin
+        if (cpu_pend_wr) begin
+            word_wr <= 1;
+            word_data <= cpu_wdata_held;
+            cpu_pend_wr <= 0;
+        end else begin
+            word_rd <= 1;
+            cpu_pend_rd <= 0;
+        end
+        word_addr <= cpu_addr_held;
+        op_cpu <= 1;
+        op_read <= !cpu_pend_wr;
+    end
+
+    if (grant_bridge || grant_cpu) begin
+        op_active <= 1;
+        op_started <= 0;
+    end else if (op_active) begin
+        if (word_busy) op_started <= 1;
+        if (op_read ? word_q_valid : (op_started && !word_busy)) op_active <= 0;
+    end
+
+    // Keep the bridge's read result: word_q also carries the CPU's reads
+    if (op_active && !op_cpu && op_read && word_q_valid) bridge_rd_word <= word_q;
+
+    // Status counters
+    if (grant_cpu) stat_cpu_ops <= stat_cpu_ops + 1;
+    if (grant_bridge) stat_bridge_ops <= stat_bridge_ops + 1;
+    if (cpu_pend && !grant_cpu) stat_cpu_wait <= stat_cpu_wait + 1;
+    if (bridge_pend && !grant_bridge) stat_bridge_wait <= stat_bridge_wait + 1;
+    if (fifo_level32 > stat_bridge_fifo_max) stat_bridge_fifo_max <= fifo_level32;
+end
+
+initial begin
+    stat_cpu_ops = 0;
+    stat_bridge_ops = 0;
+    stat_cpu_wait = 0;
+    stat_bridge_wait = 0;
+    stat_bridge_fifo_max = 0;
+    stat_bridge_fifo_overflow = 0;
+end
+
+// CPU sees its own operation only: busy from the request until its word
+// operation is done, read data valid only for its reads
+assign cpu_rdata = word_q;
+assign cpu_busy = cpu_pend | (op_active & op_cpu);
+assign cpu_rdata_valid = word_q_valid & op_active & op_cpu & op_read;
+
+endmodule
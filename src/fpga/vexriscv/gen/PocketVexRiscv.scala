@@ -0,0 +1,188 @@
+package vexriscv.demo
+
+import spinal.core._
+import spinal.lib._
+import vexriscv._
+import vexriscv.ip.{DataCacheConfig, InstructionCacheConfig}
+import vexriscv.plugin._
+
+import scala.collection.mutable.ArrayBuffer
+
+/*
+ * VexRiscv configurations for PocketLlama2
+ *
+ * Generates a drop-in replacement for src/fpga/vexriscv/VexRiscv_Full.v:
+ * module VexRiscv, Wishbone iBus/dBus, externalResetVector, interrupt inputs,
+ * no MMU, and the same cacheable range (only bit 31 set = I/O).
+ * Options pick the pipeline features compared by tools/cpu_matrix.py.
+ *
+ * Copied into a VexRiscv checkout and run with:
+ *   sbt "runMain vexriscv.demo.PocketVexRiscv --name=VexRiscv_foo --bypass=0 ..."
+ *
+ * Options (defaults reproduce VexRiscv_Full.v):
+ *   --name=STR            output file name (STR.v) in --target
+ *   --target=DIR          output directory
+ *   --bypass=0|1          register file bypassing in execute/memory/writeback
+ *   --prediction=none|static|dynamic|dynamic_target
+ *   --mul=pipelined|single|iterative
+ *                         MulPlugin (3-stage DSP), MulSimplePlugin (1-cycle),
+ *                         or MulDivIterativePlugin
+ *   --mul-unroll=N        iterative multiplier bits per cycle
+ *   --div-unroll=N        divider bits per cycle
+ *   --icache=BYTES        instruction cache size
+ *   --dcache=BYTES        data cache size
+ *   --ways=N              ways for both caches
+ *   --line=BYTES          cache line size
+ *   --shifter=barrel|light
+ */
+object PocketVexRiscv {
+  case class Options(
+    name: String = "VexRiscv",
+    target: String = ".",
+    bypass: Boolean = true,
+    prediction: BranchPrediction = STATIC,
+    mul: String = "pipelined",
+    mulUnroll: Int = 1,
+    divUnroll: Int = 1,
+    icacheBytes: Int = 4096,
+    dcacheBytes: Int = 4096,
+    ways: Int = 1,
+    lineBytes: Int = 32,
+    barrelShifter: Boolean = true
+  )
+
+  def parse(args: Array[String]): Options = args.foldLeft(Options()) { (o, arg) =>
+    arg.stripPrefix("--").split("=", 2) match {
+      case Array("name", v)       => o.copy(name = v)
+      case Array("target", v)     => o.copy(target = v)
+      case Array("bypass", v)     => o.copy(bypass = v != "0")
+      case Array("prediction", v) => o.copy(prediction = v match {
+        case "none"           => NONE
+        case "static"         => STATIC
+        case "dynamic"        => DYNAMIC
+        case "dynamic_target" => DYNAMIC_TARGET
+        case _ => throw new IllegalArgumentException(s"unknown prediction '$v'")
+      })
+      case Array("mul", v) if Seq("pipelined", "single", "iterative").contains(v) => o.copy(mul = v)
+      case Array("mul-unroll", v) => o.copy(mulUnroll = v.toInt)
+      case Array("div-unroll", v) => o.copy(divUnroll = v.toInt)
+      case Array("icache", v)     => o.copy(icacheBytes = v.toInt)
+      case Array("dcache", v)     => o.copy(dcacheBytes = v.toInt)
+      case Array("ways", v)       => o.copy(ways = v.toInt)
+      case Array("line", v)       => o.copy(lineBytes = v.toInt)
+      case Array("shifter", v)    => o.copy(barrelShifter = v == "barrel")
+      case _ => throw new IllegalArgumentException(s"unknown option '$arg'")
+    }
+  }
+
+  def plugins(o: Options): Seq[Plugin[VexRiscv]] = {
+    val p = ArrayBuffer[Plugin[VexRiscv]](
+      new IBusCachedPlugin(
+        resetVector = null,             // externalResetVector port
+        relaxedPcCalculation = false,
+        prediction = o.prediction,
+        compressedGen = false,
+        config = InstructionCacheConfig(
+          cacheSize = o.icacheBytes,
+          bytePerLine = o.lineBytes,
+          wayCount = o.ways,
+          addressWidth = 32,
+          cpuDataWidth = 32,
+          memDataWidth = 32,
+          catchIllegalAccess = true,
+          catchAccessFault = true,
+          asyncTagMemory = false,
+          twoCycleRam = true,
+          twoCycleCache = true
+        )
+      ),
+      new DBusCachedPlugin(
+        config = new DataCacheConfig(
+          cacheSize = o.dcacheBytes,
+          bytePerLine = o.lineBytes,
+          wayCount = o.ways,
+          addressWidth = 32,
+          cpuDataWidth = 32,
+          memDataWidth = 32,
+          catchAccessError = true,
+          catchIllegal = true,
+          catchUnaligned = true
+        )
+      ),
+      new StaticMemoryTranslatorPlugin(
+        ioRange = _(31 downto 31) === 1   // same as VexRiscv_Full.v
+      ),
+      new DecoderSimplePlugin(
+        catchIllegalInstruction = true
+      ),
+      new RegFilePlugin(
+        regFileReadyKind = plugin.SYNC,
+        zeroBoot = false
+      ),
+      new IntAluPlugin,
+      new SrcPlugin(
+        separatedAddSub = false,
+        executeInsertion = true
+      ),
+      if (o.barrelShifter) new FullBarrelShifterPlugin else new LightShifterPlugin,
+      new HazardSimplePlugin(
+        bypassExecute = o.bypass,
+        bypassMemory = o.bypass,
+        bypassWriteBack = o.bypass,
+        bypassWriteBackBuffer = o.bypass,
+        pessimisticUseSrc = false,
+        pessimisticWriteRegFile = false,
+        pessimisticAddressMatch = false
+      ),
+      new BranchPlugin(
+        earlyBranch = false,
+        catchAddressMisaligned = true
+      ),
+      new CsrPlugin(CsrPluginConfig.small(mtvecInit = 0x00000020l)),
+      new ExternalInterruptArrayPlugin(
+        machineMaskCsrId = 0xBC0,
+        machinePendingsCsrId = 0xFC0,
+        supervisorMaskCsrId = 0x9C0,
+        supervisorPendingsCsrId = 0xDC0
+      ),
+      new YamlPlugin(s"${o.target}/${o.name}.yaml")
+    )
+
+    o.mul match {
+      case "pipelined" => p += new MulPlugin
+      case "single"    => p += new MulSimplePlugin
+      case "iterative" =>
+    }
+    p += new MulDivIterativePlugin(
+      genMul = o.mul == "iterative",
+      genDiv = true,
+      mulUnrollFactor = o.mulUnroll,
+      divUnrollFactor = o.divUnroll
+    )
+    p
+  }
+
+  def main(args: Array[String]): Unit = {
+    val o = parse(args)
+    SpinalConfig(
+      targetDirectory = o.target,
+      netlistFileName = s"${o.name}.v"
+    ).generateVerilog {
+      val cpu = new VexRiscv(VexRiscvConfig(plugins = plugins(o)))
+
+      // Export the cached buses as Wishbone, as cpu_system.v expects
+      cpu.rework {
+        for (plugin <- cpu.plugins) plugin match {
+          case plugin: IBusCachedPlugin =>
+            plugin.iBus.setAsDirectionLess()
+            master(plugin.iBus.toWishbone()).setName("iBusWishbone")
+          case plugin: DBusCachedPlugin =>
+            plugin.dBus.setAsDirectionLess()
+            master(plugin.dBus.toWishbone()).setName("dBusWishbone")
+          case _ =>
+        }
+      }
+      cpu.setDefinitionName("VexRiscv")
+    }
+  }
+}
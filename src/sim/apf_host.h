@@ -0,0 +1,316 @@
+//
+// APF host model
+//
+// Drives the bridge bus (clk_74a) the way the Pocket does when it starts a
+// core: status poll, Reset Enter, a Data Slot Request Write (0x0082) and a
+// word stream per data slot, Data Slot All Complete (0x008F) and Reset Exit.
+// Afterwards it polls the target command registers and answers target
+// commands: 0x0140 (ready to run) and 0x0180 (data slot read).
+//
+// Command/target registers go through core_bridge_cmd's endian swap
+// (bridge_endian_little = 1), slot data is written as little-endian words.
+// Each bus access is a single-cycle bridge_wr/bridge_rd pulse followed by an
+// idle gap, so the write rate seen by sdram_arbiter is set by --bridge-gap.
+// The default, one data word per 88 cycles, is the fastest the Pocket's
+// bridge goes (io_bridge_peripheral.v), the rate sdram_arbiter is sized for.
+//
+
+#ifndef APF_HOST_H
+#define APF_HOST_H
+
+#include "Vsim_top.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ApfSlot {
+    uint16_t             id;
+    uint32_t             bridge_addr;
+    std::string          path;
+    std::vector<uint8_t> data;
+
+    uint64_t start = 0;     // clk_74a cycle of the 0x0082 command
+    uint64_t end = 0;       // clk_74a cycle after the last data word
+
+    bool load() {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) {
+            fprintf(stderr, "ERROR: cannot open %s\n", path.c_str());
+            return false;
+        }
+        uint8_t buf[65536];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+            data.insert(data.end(), buf, buf + n);
+        }
+        fclose(f);
+        return true;
+    }
+};
+
+class ApfHost {
+public:
+    // Bus timing, in clk_74a cycles
+    uint32_t word_gap = 87;     // idle cycles after each slot data word
+    uint32_t cmd_gap = 8;       // idle cycles after each command register access
+    uint32_t burst_words = 0;   // if non-zero, pause after this many data words...
+    uint32_t burst_gap = 0;     // ...for this many cycles (SD card / file system latency)
+    uint32_t poll_interval = 256;
+
+    double   ns_per_cycle = 13.468;
+
+    // Progress, for the harness
+    uint64_t cycle = 0;
+    bool     loaded = false;    // all slots streamed, 0x008F and Reset Exit acknowledged
+    uint64_t load_start = 0, load_end = 0;
+    uint32_t target_reads = 0;
+
+    std::vector<ApfSlot> slots;
+
+    void start() {
+        out = &ops;
+        status_until_ready();
+        host_cmd(0x0010);                       // Reset Enter
+        call([this] { load_start = cycle; });
+        for (auto& s : slots) {
+            call([this, &s] { s.start = cycle; });
+            host_cmd(0x0082, {s.id, (uint32_t)s.data.size()});
+            stream(s.bridge_addr, s.data.data(), (uint32_t)s.data.size());
+            call([this, &s] { s.end = cycle; report_slot(s); });
+        }
+        host_cmd(0x008F);                       // Data Slot Access All Complete
+        call([this] { load_end = cycle; });
+        host_cmd(0x0011);                       // Reset Exit
+        call([this] { loaded = true; report_load(); });
+    }
+
+    // Call after each clk_74a rising edge; sets the bus inputs for the next one
+    void tick(Vsim_top* top) {
+        cycle++;
+        top->bridge_wr = 0;
+        top->bridge_rd = 0;
+
+        if (rd_pending && --rd_wait == 0) {
+            rd_pending = false;
+            auto fn = std::move(rd_fn);
+            nested([&] { fn(top->bridge_rd_data); });
+        }
+        if (wait) {
+            wait--;
+            return;
+        }
+
+        if (ops.empty()) {
+            // Running: poll the target command register
+            if (loaded) {
+                idle(poll_interval);
+                read(TARGET_0, [this](uint32_t v) { target_cmd(bswap(v)); });
+            }
+            return;
+        }
+
+        BusOp& op = ops.front();
+        switch (op.kind) {
+        case BusOp::WRITE:
+            top->bridge_addr = op.addr;
+            top->bridge_wr_data = op.data;
+            top->bridge_wr = 1;
+            wait = cmd_gap;
+            ops.pop_front();
+            break;
+        case BusOp::READ:
+            top->bridge_addr = op.addr;
+            top->bridge_rd = 1;
+            rd_pending = true;
+            rd_wait = RD_LATENCY;
+            rd_fn = std::move(op.fn);
+            wait = RD_LATENCY + cmd_gap;
+            ops.pop_front();
+            break;
+        case BusOp::IDLE:
+            wait = op.data;
+            ops.pop_front();
+            break;
+        case BusOp::STREAM: {
+            uint32_t word = 0;
+            for (uint32_t i = 0; i < 4 && i < op.len; i++) {
+                word |= (uint32_t)op.src[i] << (i * 8);
+            }
+            top->bridge_addr = op.addr;
+            top->bridge_wr_data = word;
+            top->bridge_wr = 1;
+            wait = word_gap;
+            if (burst_words && ++burst_count == burst_words) {
+                burst_count = 0;
+                wait += burst_gap;
+            }
+            op.addr += 4;
+            op.src += 4;
+            op.len = op.len > 4 ? op.len - 4 : 0;
+            if (op.len == 0) ops.pop_front();
+            break;
+        }
+        case BusOp::CALL: {
+            auto fn = std::move(op.fn);
+            ops.pop_front();
+            nested([&] { fn(0); });
+            break;
+        }
+        }
+    }
+
+    bool busy() const { return !ops.empty() || rd_pending; }
+
+private:
+    static const uint32_t HOST_0 = 0xF8000000;
+    static const uint32_t TARGET_0 = 0xF8001000;
+    static const uint32_t RD_LATENCY = 2;
+
+    struct BusOp {
+        enum Kind { WRITE, READ, IDLE, STREAM, CALL } kind;
+        uint32_t       addr;
+        uint32_t       data;    // WRITE: word, IDLE: cycles
+        const uint8_t* src;     // STREAM: remaining bytes
+        uint32_t       len;
+        std::function<void(uint32_t)> fn;  // READ: gets the data, CALL: runs
+    };
+
+    std::deque<BusOp>  ops;
+    std::deque<BusOp>* out = &ops;  // where the helpers below append
+    uint32_t wait = 0;
+    uint32_t burst_count = 0;
+    bool     rd_pending = false;
+    uint32_t rd_wait = 0;
+    std::function<void(uint32_t)> rd_fn;
+
+    static uint32_t bswap(uint32_t v) { return __builtin_bswap32(v); }
+
+    // Ops queued from a callback run before the rest of the program
+    void nested(const std::function<void()>& fn) {
+        std::deque<BusOp> tmp;
+        out = &tmp;
+        fn();
+        out = &ops;
+        ops.insert(ops.begin(), tmp.begin(), tmp.end());
+    }
+
+    void write(uint32_t addr, uint32_t data) { out->push_back({BusOp::WRITE, addr, data, nullptr, 0, nullptr}); }
+    void read(uint32_t addr, std::function<void(uint32_t)> fn) { out->push_back({BusOp::READ, addr, 0, nullptr, 0, std::move(fn)}); }
+    void idle(uint32_t cycles) { out->push_back({BusOp::IDLE, 0, cycles, nullptr, 0, nullptr}); }
+    void call(std::function<void()> fn) {
+        out->push_back({BusOp::CALL, 0, 0, nullptr, 0, [fn](uint32_t) { fn(); }});
+    }
+    void stream(uint32_t addr, const uint8_t* src, uint32_t len) {
+        if (len) out->push_back({BusOp::STREAM, addr, 0, src, len, nullptr});
+    }
+
+    // ============================================
+    // Host commands (0xF8xx00xx)
+    // ============================================
+
+    void host_cmd(uint16_t cmd, std::vector<uint32_t> params = {},
+                  std::function<void(uint16_t)> done = nullptr) {
+        for (size_t i = 0; i < params.size(); i++) {
+            write(HOST_0 + 0x20 + 4 * i, bswap(params[i]));
+        }
+        write(HOST_0, bswap(0x434D0000 | cmd));
+        poll_host(cmd, done);
+    }
+
+    void poll_host(uint16_t cmd, std::function<void(uint16_t)> done) {
+        read(HOST_0, [this, cmd, done](uint32_t v) {
+            v = bswap(v);
+            if ((v >> 16) == 0x4F4B) {
+                if (done) done(v & 0xFFFF);
+                else if ((v & 0xFFFF) == 0xFFFF) fprintf(stderr, "APF host cmd 0x%04X: unknown\n", cmd);
+            } else {
+                idle(poll_interval);
+                poll_host(cmd, done);
+            }
+        });
+    }
+
+    // Request Status until the core reports boot done (2 = setup, 3 = idle, 4 = running)
+    void status_until_ready() {
+        host_cmd(0x0000, {}, [this](uint16_t code) {
+            if (code < 2) {
+                idle(poll_interval);
+                status_until_ready();
+            }
+        });
+    }
+
+    // ============================================
+    // Target commands (0xF8xx10xx)
+    // ============================================
+
+    void target_reply(uint32_t err) { write(TARGET_0, bswap(0x6F6B0000 | err)); }
+
+    void target_cmd(uint32_t v) {
+        if ((v >> 16) != 0x636D) return;
+        uint16_t cmd = v & 0xFFFF;
+        if (cmd == 0x0140) {
+            // Ready to run
+            target_reply(0);
+        } else if (cmd == 0x0180) {
+            // Data slot read: params are id, slot offset, bridge address, length
+            auto p = std::make_shared<std::vector<uint32_t>>();
+            for (uint32_t i = 0; i < 4; i++) {
+                read(TARGET_0 + 0x20 + 4 * i, [p](uint32_t d) { p->push_back(bswap(d)); });
+            }
+            call([this, p] { target_read((*p)[0], (*p)[1], (*p)[2], (*p)[3]); });
+        } else {
+            fprintf(stderr, "APF target cmd 0x%04X: not supported\n", cmd);
+            target_reply(1);
+        }
+    }
+
+    void target_read(uint32_t id, uint32_t offset, uint32_t addr, uint32_t length) {
+        write(TARGET_0, bswap(0x62750000 | 0x0180));  // busy
+        const ApfSlot* slot = nullptr;
+        for (auto& s : slots) {
+            if (s.id == id) slot = &s;
+        }
+        if (!slot || offset >= slot->data.size()) {
+            fprintf(stderr, "APF target read: slot %u offset 0x%X not loaded\n", id, offset);
+            target_reply(2);
+            return;
+        }
+        if (length > slot->data.size() - offset) length = slot->data.size() - offset;
+        uint64_t start = cycle;
+        stream(addr, slot->data.data() + offset, length);
+        call([this, id, offset, addr, length, start] {
+            target_reads++;
+            fprintf(stderr, "APF target read: slot %u +0x%X -> 0x%08X, %u bytes in %.3f ms\n",
+                    id, offset, addr, length, (cycle - start) * ns_per_cycle / 1e6);
+        });
+        target_reply(0);
+    }
+
+    // ============================================
+    // Reporting
+    // ============================================
+
+    void report_slot(const ApfSlot& s) {
+        double ms = (s.end - s.start) * ns_per_cycle / 1e6;
+        fprintf(stderr, "APF slot %u %s: %zu bytes -> 0x%08X in %llu cycles, %.3f ms, %.2f MB/s\n",
+                s.id, s.path.c_str(), s.data.size(), s.bridge_addr,
+                (unsigned long long)(s.end - s.start), ms,
+                ms > 0 ? s.data.size() / 1e3 / ms : 0.0);
+    }
+
+    void report_load() {
+        size_t bytes = 0;
+        for (auto& s : slots) bytes += s.data.size();
+        fprintf(stderr, "APF load: %zu slots, %zu bytes in %.3f ms (all complete + reset exit at %.3f ms)\n",
+                slots.size(), bytes, (load_end - load_start) * ns_per_cycle / 1e6,
+                cycle * ns_per_cycle / 1e6);
+    }
+};
+
+#endif
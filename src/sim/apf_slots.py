@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+"""
+Turn the data slots in data.json into Vsim_top arguments.
+
+Each slot becomes "--slot ID ADDR FILE" (streamed over the bridge by the APF
+host model) or, with --preload, "--load ADDR FILE" (copied into SDRAM before
+reset). FILE is the slot's "filename" looked up in the asset directory.
+
+Usage:
+    python3 apf_slots.py ../../data.json ../../dist/assets
+    python3 apf_slots.py --preload ../../data.json ../../dist/assets
+"""
+
+import argparse
+import json
+import os
+import sys
+
+
+def main():
+    parser = argparse.ArgumentParser(description='data.json slots to Vsim_top arguments')
+    parser.add_argument('data_json')
+    parser.add_argument('asset_dir')
+    parser.add_argument('--preload', action='store_true', help='emit --load instead of --slot')
+    args = parser.parse_args()
+
+    with open(args.data_json) as f:
+        slots = json.load(f)['data']['data_slots']
+
+    out = []
+    for slot in slots:
+        if 'filename' not in slot:
+            continue
+        path = os.path.abspath(os.path.join(args.asset_dir, slot['filename']))
+        if not os.path.exists(path):
+            if slot.get('required'):
+                print('ERROR: %s not found for slot %d' % (path, slot['id']), file=sys.stderr)
+                sys.exit(1)
+            continue
+        if args.preload:
+            out += ['--load', slot['address'], path]
+        else:
+            out += ['--slot', str(slot['id']), slot['address'], path]
+    print(' '.join(out))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""
+Compare forward() timings of two benchmark runs (bench.log).
+
+Prints a markdown table of fwd_avg_cyc and fwd_pos*_cyc for a baseline and a
+candidate run, with the change, and the cycles the bus had more than one
+transaction in flight (fwd_pos*_overlap_cyc, SYS_BUS_OVERLAP) as a share of
+each timed call.
+
+Usage:
+    python3 bench_diff.py build/Full-serial/bench.log build/Full/bench.log
+"""
+
+import argparse
+import re
+import sys
+
+
+def parse_bench(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            if line.startswith('BENCH '):
+                for key, value in re.findall(r'(\w+)=(-?\d+)', line):
+                    results[key] = int(value)
+    return results
+
+
+def share(part, whole):
+    return '-' if part is None or not whole else '%.1f%%' % (100.0 * part / whole)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='compare two bench.log files')
+    parser.add_argument('baseline')
+    parser.add_argument('candidate')
+    args = parser.parse_args()
+
+    base = parse_bench(args.baseline)
+    cand = parse_bench(args.candidate)
+    positions = sorted(int(m.group(1)) for m in
+                       (re.match(r'fwd_pos(\d+)_cyc$', k) for k in base) if m and
+                       'fwd_pos%s_cyc' % m.group(1) in cand)
+    if not positions and 'fwd_avg_cyc' not in base:
+        print('ERROR: no forward() timings in %s' % args.baseline, file=sys.stderr)
+        sys.exit(1)
+
+    print('`%s` (baseline) vs `%s`\n' % (args.baseline, args.candidate))
+    print('| forward() | Baseline cycles | Candidate cycles | Change | Baseline overlap | Candidate overlap |')
+    print('|---|---:|---:|---:|---:|---:|')
+    rows = [('average of %d tokens' % base.get('tokens', 0), 'fwd_avg_cyc', None)]
+    rows += [('pos %d' % p, 'fwd_pos%d_cyc' % p, 'fwd_pos%d_overlap_cyc' % p) for p in positions]
+    for label, key, overlap in rows:
+        b, c = base.get(key), cand.get(key)
+        change = '-' if not b or c is None else '%+.1f%%' % (100.0 * (c - b) / b)
+        print('| %s | %s | %s | %s | %s | %s |' % (
+            label, '-' if b is None else '{:,}'.format(b), '-' if c is None else '{:,}'.format(c), change,
+            share(base.get(overlap), b) if overlap else '-', share(cand.get(overlap), c) if overlap else '-'))
+    print('\nOverlap: cycles of the timed call with more than one memory transaction in flight.')
+
+
+if __name__ == '__main__':
+    main()
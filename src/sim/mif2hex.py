@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""
+Convert a Quartus MIF file to a $readmemh hex file for the altsyncram model.
+
+Usage:
+    ./mif2hex.py input.mif output.hex
+"""
+
+import re
+import sys
+
+
+def parse_mif(path):
+    depth = 0
+    addr_radix = 16
+    data_radix = 16
+    words = {}
+    in_content = False
+
+    with open(path) as f:
+        for raw in f:
+            line = raw.split('--')[0].strip()
+            if not line:
+                continue
+            upper = line.upper()
+            if not in_content:
+                m = re.match(r'(DEPTH|ADDRESS_RADIX|DATA_RADIX)\s*=\s*(\w+)\s*;', upper)
+                if m:
+                    key, val = m.groups()
+                    if key == 'DEPTH':
+                        depth = int(val)
+                    else:
+                        radix = {'HEX': 16, 'DEC': 10, 'UNS': 10, 'BIN': 2}[val]
+                        if key == 'ADDRESS_RADIX':
+                            addr_radix = radix
+                        else:
+                            data_radix = radix
+                elif upper.startswith('CONTENT'):
+                    in_content = True
+                continue
+            if upper.startswith('BEGIN'):
+                continue
+            if upper.startswith('END'):
+                break
+
+            addr, data = [x.strip() for x in line.rstrip(';').split(':')]
+            value = int(data, data_radix)
+            if addr.startswith('['):
+                lo, hi = addr.strip('[]').split('..')
+                for a in range(int(lo, addr_radix), int(hi, addr_radix) + 1):
+                    words[a] = value
+            else:
+                words[int(addr, addr_radix)] = value
+
+    return depth, words
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+    depth, words = parse_mif(sys.argv[1])
+    with open(sys.argv[2], 'w') as f:
+        for a in range(depth):
+            f.write('%08x\n' % words.get(a, 0))
+
+
+if __name__ == '__main__':
+    main()
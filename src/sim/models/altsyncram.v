@@ -0,0 +1,136 @@
+//
+// Behavioral altsyncram for Verilator
+// - Covers the SINGLE_PORT and BIDIR_DUAL_PORT uses in this core; port B only
+//   exists in BIDIR_DUAL_PORT (q_b is 0 otherwise)
+// - Address is always registered; q is registered again when outdata_reg_x is set
+// - init_file is loaded from "<init_file>.hex" ($readmemh), see mif2hex.py
+// - Port B widths default to 1 as in the Altera library, so instances that
+//   leave port B unused tie it off with 1-bit constants
+//
+
+`default_nettype none
+
+module altsyncram #(
+    parameter string operation_mode = "SINGLE_PORT",
+    parameter width_a = 32,
+    parameter widthad_a = 8,
+    parameter numwords_a = 256,
+    parameter width_byteena_a = 1,
+    parameter width_b = 1,
+    parameter widthad_b = 1,
+    parameter width_byteena_b = 1,
+    parameter string outdata_reg_a = "UNREGISTERED",
+    parameter string outdata_reg_b = "UNREGISTERED",
+    parameter string init_file = "UNUSED",
+
+    // Accepted for compatibility, not modelled
+    /* verilator lint_off UNUSED */
+    parameter numwords_b = 1,
+    parameter lpm_type = "altsyncram",
+    parameter intended_device_family = "Cyclone V",
+    parameter read_during_write_mode_port_a = "NEW_DATA_NO_NBE_READ",
+    parameter read_during_write_mode_port_b = "NEW_DATA_NO_NBE_READ",
+    parameter read_during_write_mode_mixed_ports = "DONT_CARE",
+    parameter address_reg_b = "CLOCK1",
+    parameter indata_reg_b = "CLOCK1",
+    parameter wrcontrol_wraddress_reg_b = "CLOCK1",
+    parameter clock_enable_input_a = "BYPASS",
+    parameter clock_enable_input_b = "BYPASS",
+    parameter clock_enable_output_a = "BYPASS",
+    parameter clock_enable_output_b = "BYPASS",
+    parameter outdata_aclr_a = "NONE",
+    parameter outdata_aclr_b = "NONE",
+    parameter power_up_uninitialized = "FALSE"
+    /* verilator lint_on UNUSED */
+) (
+    input wire                        clock0,
+    input wire [widthad_a-1:0]        address_a,
+    input wire [width_a-1:0]          data_a,
+    input wire                        wren_a,
+    input wire [width_byteena_a-1:0]  byteena_a,
+    output wire [width_a-1:0]         q_a,
+
+    // Port B, read only in BIDIR_DUAL_PORT; the rest is not modelled
+    /* verilator lint_off UNUSED */
+    input wire                        clock1,
+    input wire [widthad_b-1:0]        address_b,
+    input wire [width_b-1:0]          data_b,
+    input wire                        wren_b,
+    input wire [width_byteena_b-1:0]  byteena_b,
+    output wire [width_b-1:0]         q_b,
+    input wire                        aclr0,
+    input wire                        aclr1,
+    input wire                        addressstall_a,
+    input wire                        addressstall_b,
+    input wire                        clocken0,
+    input wire                        clocken1,
+    input wire                        clocken2,
+    input wire                        clocken3,
+    input wire                        rden_a,
+    input wire                        rden_b,
+    /* verilator lint_on UNUSED */
+    output wire [2:0]                 eccstatus
+);
+
+// Written from both clocks in BIDIR_DUAL_PORT (true dual-port RAM)
+/* verilator lint_off MULTIDRIVEN */
+reg [width_a-1:0] mem [0:numwords_a-1];
+/* verilator lint_on MULTIDRIVEN */
+
+initial begin
+    if (init_file != "UNUSED") begin
+        $readmemh({init_file, ".hex"}, mem);
+    end
+end
+
+assign eccstatus = 3'b0;
+
+// Port A
+reg [widthad_a-1:0] addr_a_reg;
+reg [width_a-1:0]   q_a_reg;
+integer i;
+
+always @(posedge clock0) begin
+    if (wren_a) begin
+        if (width_byteena_a == 1) begin
+            mem[address_a] <= data_a;
+        end else begin
+            for (i = 0; i < width_byteena_a; i = i + 1) begin
+                if (byteena_a[i]) mem[address_a][i*8 +: 8] <= data_a[i*8 +: 8];
+            end
+        end
+    end
+    addr_a_reg <= address_a;
+    q_a_reg <= mem[addr_a_reg];
+end
+
+assign q_a = (outdata_reg_a == "CLOCK0") ? q_a_reg : mem[addr_a_reg];
+
+// Port B (BIDIR_DUAL_PORT only, width_b == width_a)
+generate
+if (operation_mode == "BIDIR_DUAL_PORT") begin : port_b
+    reg [widthad_b-1:0] addr_b_reg;
+    reg [width_b-1:0]   q_b_reg;
+    integer j;
+
+    always @(posedge clock1) begin
+        if (wren_b) begin
+            if (width_byteena_b == 1) begin
+                mem[address_b] <= data_b;
+            end else begin
+                for (j = 0; j < width_byteena_b; j = j + 1) begin
+                    if (byteena_b[j]) mem[address_b][j*8 +: 8] <= data_b[j*8 +: 8];
+                end
+            end
+        end
+        addr_b_reg <= address_b;
+        q_b_reg <= mem[addr_b_reg];
+    end
+
+    assign q_b = (outdata_reg_b == "CLOCK1") ? q_b_reg : mem[addr_b_reg];
+end else begin : no_port_b
+    assign q_b = {width_b{1'b0}};
+end
+endgenerate
+
+endmodule
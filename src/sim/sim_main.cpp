@@ -0,0 +1,326 @@
+//
+// Verilator harness for cpu_system
+//
+// Models the io_sdram / psram_controller word interfaces, the text terminal and
+// the APF host (apf_host.h) around the real CPU, bridge command and SDRAM
+// arbiter RTL, and streams the firmware's SIM_CONSOLE output to stdout.
+//
+// Data slot files are either preloaded into SDRAM (--load, fast, for
+// benchmarks) or streamed over the bridge by the host model (--slot), which
+// reports the load time and checks the SDRAM contents against the files and
+// the arbiter FIFO overflow flag.
+//
+// Usage:
+//   Vsim_top [--load BRIDGE_ADDR FILE]... [--slot ID BRIDGE_ADDR FILE]...
+//            [--bridge-gap N] [--bridge-burst WORDS GAP]
+//            [--target-read ID OFFSET BRIDGE_ADDR LENGTH] [--exit-after-load]
+//            [--max-cycles N] [--sdram-lat READ WRITE] [--psram-lat N]
+//
+
+#include "Vsim_top.h"
+#include "verilated.h"
+#include "apf_host.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Clock periods in ps (PLL outclk_2 = 133.33 MHz, clk_74a = 74.25 MHz)
+static const uint64_t CLK_CPU_HALF_PS = 3750;
+static const uint64_t CLK_74A_HALF_PS = 6734;
+
+static const uint32_t SDRAM_WORDS      = 16 * 1024 * 1024;  // 64MB
+static const uint32_t PSRAM_WORDS      = 4 * 1024 * 1024;   // 16MB
+static const uint32_t SIM_CONSOLE_WORD = 0x1FFC >> 2;       // terminal.h SIM_CONSOLE_ADDR
+static const char     SIM_CONSOLE_EOT  = 0x04;
+
+// ============================================
+// Word RAM model (io_sdram / psram_controller)
+// ============================================
+// rd/wr are single-cycle pulses. busy rises on the next cycle and stays high
+// for the access latency. Reads pulse q_valid with the data when busy drops.
+
+struct WordRam {
+    std::vector<uint32_t> mem;
+    uint32_t rd_latency;
+    uint32_t wr_latency;
+
+    uint32_t count = 0;
+    bool     busy = false;
+    bool     reading = false;
+    uint32_t addr = 0;
+    uint32_t q = 0;
+    bool     q_valid = false;
+
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+
+    WordRam(uint32_t words, uint32_t rd_lat, uint32_t wr_lat)
+        : mem(words, 0), rd_latency(rd_lat), wr_latency(wr_lat) {}
+
+    // Call once per rising edge with the request outputs of the RTL
+    void tick(bool rd, bool wr, uint32_t req_addr, uint32_t wdata) {
+        q_valid = false;
+        if (busy) {
+            if (--count == 0) {
+                busy = false;
+                if (reading) {
+                    q = mem[addr % mem.size()];
+                    q_valid = true;
+                }
+            }
+        } else if (wr) {
+            mem[req_addr % mem.size()] = wdata;
+            busy = true;
+            reading = false;
+            count = wr_latency;
+            writes++;
+        } else if (rd) {
+            addr = req_addr;
+            busy = true;
+            reading = true;
+            count = rd_latency;
+            reads++;
+        }
+    }
+
+    bool load(uint32_t byte_addr, const char* path) {
+        FILE* f = fopen(path, "rb");
+        if (!f) {
+            fprintf(stderr, "ERROR: cannot open %s\n", path);
+            return false;
+        }
+        uint8_t* base = reinterpret_cast<uint8_t*>(mem.data());
+        size_t max = mem.size() * 4 - byte_addr;
+        size_t n = fread(base + byte_addr, 1, max, f);
+        fclose(f);
+        fprintf(stderr, "Loaded %s: %zu bytes at 0x%08X\n", path, n, byte_addr);
+        return true;
+    }
+
+    // Count words in [byte_addr, byte_addr + len) that differ from data
+    uint32_t verify(uint32_t byte_addr, const uint8_t* data, uint32_t len, uint32_t* first_bad) {
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(mem.data());
+        uint32_t bad = 0;
+        for (uint32_t i = 0; i < len; i += 4) {
+            uint32_t n = len - i < 4 ? len - i : 4;
+            if (memcmp(base + byte_addr + i, data + i, n) != 0) {
+                if (bad++ == 0) *first_bad = byte_addr + i;
+            }
+        }
+        return bad;
+    }
+};
+
+// ============================================
+// Terminal model (text_terminal.v handshake)
+// ============================================
+
+struct Terminal {
+    bool pending = false;
+    bool ready = false;
+    bool eot = false;
+    bool error = false;     // the firmware printed an "ERROR:" line; it halts after those
+    std::string line;
+
+    void tick(Vsim_top* top) {
+        ready = false;
+        if (pending) {
+            pending = false;
+            ready = true;
+        } else if (top->term_mem_valid && !top->term_mem_ready) {
+            pending = true;
+            uint32_t word = (top->term_mem_addr & 0x1FFF) >> 2;
+            if (word == SIM_CONSOLE_WORD && top->term_mem_wstrb) {
+                int lane = __builtin_ctz(top->term_mem_wstrb);
+                char c = (char)(top->term_mem_wdata >> (lane * 8));
+                if (c == SIM_CONSOLE_EOT) {
+                    eot = true;
+                } else {
+                    fputc(c, stdout);
+                    if (c != '\n') {
+                        line += c;
+                    } else {
+                        if (line.compare(0, 6, "ERROR:") == 0) error = eot = true;
+                        line.clear();
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Check slot data landed in SDRAM; returns false on mismatch
+static bool verify_slot(WordRam& sdram, const char* what, uint32_t addr, const uint8_t* data, uint32_t len) {
+    uint32_t first_bad = 0;
+    uint32_t bad = sdram.verify(addr, data, len, &first_bad);
+    if (bad) {
+        fprintf(stderr, "APF verify %s: %u of %u words differ, first at 0x%08X\n",
+                what, bad, (len + 3) / 4, first_bad);
+        return false;
+    }
+    fprintf(stderr, "APF verify %s: %u bytes OK\n", what, len);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    uint64_t max_cycles = 40000000000ull;
+    uint32_t sdram_rd_lat = 14, sdram_wr_lat = 10;
+    uint32_t psram_lat = 24;
+    bool exit_after_load = false;
+    bool target_read = false;
+    uint32_t target_args[4] = {0, 0, 0, 0};  // id, slot offset, bridge addr, length
+    std::vector<std::pair<uint32_t, const char*>> loads;
+    ApfHost host;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--load") && i + 2 < argc) {
+            loads.push_back({(uint32_t)strtoul(argv[i + 1], nullptr, 0), argv[i + 2]});
+            i += 2;
+        } else if (!strcmp(argv[i], "--slot") && i + 3 < argc) {
+            ApfSlot slot;
+            slot.id = (uint16_t)strtoul(argv[i + 1], nullptr, 0);
+            slot.bridge_addr = (uint32_t)strtoul(argv[i + 2], nullptr, 0);
+            slot.path = argv[i + 3];
+            host.slots.push_back(slot);
+            i += 3;
+        } else if (!strcmp(argv[i], "--bridge-gap") && i + 1 < argc) {
+            host.word_gap = strtoul(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--bridge-burst") && i + 2 < argc) {
+            host.burst_words = strtoul(argv[i + 1], nullptr, 0);
+            host.burst_gap = strtoul(argv[i + 2], nullptr, 0);
+            i += 2;
+        } else if (!strcmp(argv[i], "--target-read") && i + 4 < argc) {
+            target_read = true;
+            for (int j = 0; j < 4; j++) target_args[j] = strtoul(argv[i + 1 + j], nullptr, 0);
+            i += 4;
+        } else if (!strcmp(argv[i], "--exit-after-load")) {
+            exit_after_load = true;
+        } else if (!strcmp(argv[i], "--max-cycles") && i + 1 < argc) {
+            max_cycles = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--sdram-lat") && i + 2 < argc) {
+            sdram_rd_lat = strtoul(argv[i + 1], nullptr, 0);
+            sdram_wr_lat = strtoul(argv[i + 2], nullptr, 0);
+            i += 2;
+        } else if (!strcmp(argv[i], "--psram-lat") && i + 1 < argc) {
+            psram_lat = strtoul(argv[++i], nullptr, 0);
+        }
+    }
+
+    WordRam sdram(SDRAM_WORDS, sdram_rd_lat, sdram_wr_lat);
+    WordRam psram(PSRAM_WORDS, psram_lat, psram_lat);
+    Terminal term;
+
+    // Preloaded slots are already in SDRAM at reset; streamed ones go over the bridge
+    for (auto& l : loads) {
+        if (!sdram.load(l.first, l.second)) return 1;
+    }
+    for (auto& s : host.slots) {
+        if (!s.load()) return 1;
+    }
+    host.ns_per_cycle = 2 * CLK_74A_HALF_PS / 1000.0;
+    host.start();
+
+    Vsim_top* top = new Vsim_top;
+    top->clk = 0;
+    top->clk_74a = 0;
+    top->pll_core_locked = 0;
+    top->target_dataslot_read = 0;
+    top->eval();
+
+    uint64_t t_cpu = CLK_CPU_HALF_PS, t_74a = CLK_74A_HALF_PS;
+    uint64_t cycles = 0;
+    uint64_t run_cycle = 0;         // CPU cycle at which the CPU left reset
+    bool verified = false, ok = true;
+    enum { TR_IDLE, TR_ISSUED, TR_DONE } tr_state = TR_IDLE;
+
+    while (cycles < max_cycles && !term.eot && !Verilated::gotFinish()) {
+        if (t_74a < t_cpu) {
+            top->clk_74a = !top->clk_74a;
+            top->eval();
+            t_74a += CLK_74A_HALF_PS;
+            if (!top->clk_74a) continue;
+
+            // Rising edge of the bridge clock: APF host
+            if (host.cycle == 16) top->pll_core_locked = 1;
+            host.tick(top);
+
+            if (host.loaded && !verified) {
+                verified = true;
+                for (auto& s : host.slots) {
+                    ok &= verify_slot(sdram, s.path.c_str(), s.bridge_addr, s.data.data(), s.data.size());
+                }
+                if (top->bridge_fifo_overflow) {
+                    fprintf(stderr, "APF bridge FIFO overflow: sdram_arbiter dropped bridge writes\n");
+                    ok = false;
+                }
+            }
+
+            // Target-initiated data slot read, once the core is running
+            if (target_read && host.loaded) {
+                if (tr_state == TR_IDLE) {
+                    top->target_dataslot_id = target_args[0];
+                    top->target_dataslot_slotoffset = target_args[1];
+                    top->target_dataslot_bridgeaddr = target_args[2];
+                    top->target_dataslot_length = target_args[3];
+                    top->target_dataslot_read = 1;
+                    tr_state = TR_ISSUED;
+                } else if (tr_state == TR_ISSUED && top->target_dataslot_done) {
+                    top->target_dataslot_read = 0;
+                    tr_state = TR_DONE;
+                    fprintf(stderr, "APF target read done, err=%u\n", top->target_dataslot_err);
+                    ok &= top->target_dataslot_err == 0;
+                    for (auto& s : host.slots) {
+                        if (s.id != target_args[0] || target_args[1] >= s.data.size()) continue;
+                        uint32_t len = target_args[3];
+                        if (len > s.data.size() - target_args[1]) len = s.data.size() - target_args[1];
+                        ok &= verify_slot(sdram, "target read", target_args[2],
+                                          s.data.data() + target_args[1], len);
+                    }
+                }
+            }
+            if (exit_after_load && verified && (!target_read || tr_state == TR_DONE)) break;
+            continue;
+        }
+
+        top->clk = !top->clk;
+        top->eval();
+        t_cpu += CLK_CPU_HALF_PS;
+        if (!top->clk) continue;
+
+        // Rising edge: RTL outputs are now valid for this cycle
+        cycles++;
+        if (!run_cycle && top->cpu_reset_n) run_cycle = cycles;
+
+        sdram.tick(top->sdram_rd, top->sdram_wr, top->sdram_addr, top->sdram_wdata);
+        psram.tick(top->psram_rd, top->psram_wr, top->psram_addr, top->psram_wdata);
+        term.tick(top);
+
+        top->sdram_busy = sdram.busy;
+        top->sdram_rdata = sdram.q;
+        top->sdram_rdata_valid = sdram.q_valid;
+        top->psram_busy = psram.busy;
+        top->psram_rdata = psram.q;
+        top->term_mem_ready = term.ready;
+        top->term_mem_rdata = 0;
+    }
+
+    bool done = term.eot || (exit_after_load && verified);
+    fflush(stdout);
+    fprintf(stderr, "\nSIM cycles=%llu run_cycle=%llu sdram_rd=%llu sdram_wr=%llu psram_rd=%llu psram_wr=%llu%s\n",
+            (unsigned long long)cycles, (unsigned long long)run_cycle,
+            (unsigned long long)sdram.reads, (unsigned long long)sdram.writes,
+            (unsigned long long)psram.reads, (unsigned long long)psram.writes,
+            term.error ? " (firmware error)" : done ? "" : " (timeout)");
+
+    top->final();
+    delete top;
+    if (!ok) return 3;
+    if (term.error) return 4;
+    return done ? 0 : 2;
+}
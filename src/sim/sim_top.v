@@ -0,0 +1,310 @@
+//
+// Verilator top-level for firmware benchmarking and load-path testing
+// - cpu_system (VexRiscv + BRAM + sysregs), core_bridge_cmd, sdram_arbiter and
+//   dataslot_crc are the real RTL, wired up as in core_top.v
+// - The APF host (bridge bus), SDRAM, PSRAM and terminal are modelled in sim_main.cpp
+// - The VexRiscv configuration is picked by the Makefile (CPU_V)
+// - SPLIT_BUS picks the cpu_system interconnect (Makefile SPLIT_BUS=0: serial)
+//
+
+`default_nettype none
+
+module sim_top #(
+    parameter SPLIT_BUS = 1            // cpu_system interconnect (0: serial baseline)
+) (
+    input wire         clk,            // CPU / SDRAM controller clock (133 MHz)
+    input wire         clk_74a,        // Bridge clock (74.25 MHz)
+    input wire         pll_core_locked,
+
+    // APF bridge bus (clk_74a), driven by the host model
+    input wire  [31:0] bridge_addr,
+    input wire         bridge_rd,
+    output reg  [31:0] bridge_rd_data,
+    input wire         bridge_wr,
+    input wire  [31:0] bridge_wr_data,
+
+    // Core state, for reporting
+    output wire        reset_n,
+    output wire        cpu_reset_n,
+    output wire        dataslot_allcomplete,
+    output wire        bridge_fifo_overflow,   // sdram_arbiter dropped a bridge write
+
+    // Target-initiated data slot read (core_bridge_cmd target_dataslot_*)
+    input wire         target_dataslot_read,
+    input wire  [15:0] target_dataslot_id,
+    input wire  [31:0] target_dataslot_slotoffset,
+    input wire  [31:0] target_dataslot_bridgeaddr,
+    input wire  [31:0] target_dataslot_length,
+    output wire        target_dataslot_ack,
+    output wire        target_dataslot_done,
+    output wire [2:0]  target_dataslot_err,
+
+    // Terminal memory interface
+    output wire        term_mem_valid,
+    output wire [31:0] term_mem_addr,
+    output wire [31:0] term_mem_wdata,
+    output wire [3:0]  term_mem_wstrb,
+    input wire  [31:0] term_mem_rdata,
+    input wire         term_mem_ready,
+
+    // SDRAM word interface (io_sdram)
+    output wire        sdram_rd,
+    output wire        sdram_wr,
+    output wire [23:0] sdram_addr,
+    output wire [31:0] sdram_wdata,
+    input wire  [31:0] sdram_rdata,
+    input wire         sdram_busy,
+    input wire         sdram_rdata_valid,
+
+    // PSRAM word interface (psram_controller)
+    output wire        psram_rd,
+    output wire        psram_wr,
+    output wire [21:0] psram_addr,
+    output wire [31:0] psram_wdata,
+    input wire  [31:0] psram_rdata,
+    input wire         psram_busy
+);
+
+// ============================================
+// Bridge read data mux (as core_top)
+// ============================================
+wire [31:0] cmd_bridge_rd_data;
+wire [31:0] ram1_bridge_rd_data;
+
+always @(*) begin
+    casez(bridge_addr)
+    default: begin
+        bridge_rd_data = 32'h0;
+    end
+    32'b000000??_????????_????????_????????: begin
+        bridge_rd_data = ram1_bridge_rd_data;
+    end
+    32'hF8??????: begin
+        bridge_rd_data = cmd_bridge_rd_data;
+    end
+    endcase
+end
+
+// ============================================
+// Host/target command handler
+// ============================================
+wire pll_core_locked_s;
+synch_3 s01(.i(pll_core_locked), .o(pll_core_locked_s), .clk(clk_74a), .rise(), .fall());
+
+wire        dataslot_requestwrite;
+wire [15:0] dataslot_requestwrite_id;
+wire [31:0] dataslot_requestwrite_size;
+
+core_bridge_cmd icb (
+    .clk                        ( clk_74a ),
+    .reset_n                    ( reset_n ),
+
+    .bridge_endian_little       ( 1'b1 ),
+    .bridge_addr                ( bridge_addr ),
+    .bridge_rd                  ( bridge_rd ),
+    .bridge_rd_data             ( cmd_bridge_rd_data ),
+    .bridge_wr                  ( bridge_wr ),
+    .bridge_wr_data             ( bridge_wr_data ),
+
+    .status_boot_done           ( pll_core_locked_s ),
+    .status_setup_done          ( pll_core_locked_s ),
+    .status_running             ( reset_n ),
+
+    .dataslot_requestread       ( ),
+    .dataslot_requestread_id    ( ),
+    .dataslot_requestread_ack   ( 1'b1 ),
+    .dataslot_requestread_ok    ( 1'b1 ),
+
+    .dataslot_requestwrite      ( dataslot_requestwrite ),
+    .dataslot_requestwrite_id   ( dataslot_requestwrite_id ),
+    .dataslot_requestwrite_size ( dataslot_requestwrite_size ),
+    .dataslot_requestwrite_ack  ( 1'b1 ),
+    .dataslot_requestwrite_ok   ( 1'b1 ),
+
+    .dataslot_update            ( ),
+    .dataslot_update_id         ( ),
+    .dataslot_update_size       ( ),
+
+    .dataslot_allcomplete       ( dataslot_allcomplete ),
+
+    .rtc_epoch_seconds          ( ),
+    .rtc_date_bcd               ( ),
+    .rtc_time_bcd               ( ),
+    .rtc_valid                  ( ),
+
+    .savestate_supported        ( 1'b0 ),
+    .savestate_addr             ( 32'h0 ),
+    .savestate_size             ( 32'h0 ),
+    .savestate_maxloadsize      ( 32'h0 ),
+
+    .savestate_start            ( ),
+    .savestate_start_ack        ( 1'b0 ),
+    .savestate_start_busy       ( 1'b0 ),
+    .savestate_start_ok         ( 1'b0 ),
+    .savestate_start_err        ( 1'b0 ),
+
+    .savestate_load             ( ),
+    .savestate_load_ack         ( 1'b0 ),
+    .savestate_load_busy        ( 1'b0 ),
+    .savestate_load_ok          ( 1'b0 ),
+    .savestate_load_err         ( 1'b0 ),
+
+    .osnotify_inmenu            ( ),
+
+    .target_dataslot_read       ( target_dataslot_read ),
+    .target_dataslot_write      ( 1'b0 ),
+    .target_dataslot_getfile    ( 1'b0 ),
+    .target_dataslot_openfile   ( 1'b0 ),
+
+    .target_dataslot_ack        ( target_dataslot_ack ),
+    .target_dataslot_done       ( target_dataslot_done ),
+    .target_dataslot_err        ( target_dataslot_err ),
+
+    .target_dataslot_id         ( target_dataslot_id ),
+    .target_dataslot_slotoffset ( target_dataslot_slotoffset ),
+    .target_dataslot_bridgeaddr ( target_dataslot_bridgeaddr ),
+    .target_dataslot_length     ( target_dataslot_length ),
+
+    .target_buffer_param_struct ( 32'h0 ),
+    .target_buffer_resp_struct  ( 32'h0 ),
+
+    .datatable_addr             ( 10'h0 ),
+    .datatable_wren             ( 1'b0 ),
+    .datatable_data             ( 32'h0 ),
+    .datatable_q                ( )
+);
+
+// ============================================
+// Bridge/CPU SDRAM arbitration
+// ============================================
+wire        cpu_sdram_rd;
+wire        cpu_sdram_wr;
+wire [23:0] cpu_sdram_addr;
+wire [31:0] cpu_sdram_wdata;
+wire [31:0] cpu_sdram_rdata;
+wire        cpu_sdram_busy;
+wire        cpu_sdram_rdata_valid;
+
+// SDRAM arbiter control/status (cpu_system system registers)
+wire [4:0]  sdram_bridge_share;
+wire [31:0] sdram_arb_cpu_ops;
+wire [31:0] sdram_arb_bridge_ops;
+wire [31:0] sdram_arb_cpu_wait;
+wire [31:0] sdram_arb_bridge_wait;
+wire [31:0] sdram_arb_bridge_fifo_max;
+wire        sdram_arb_bridge_overflow;
+assign bridge_fifo_overflow = sdram_arb_bridge_overflow;
+
+// Data slot CRC32 (dataslot_crc, cpu_system system registers)
+wire         sdram_bridge_word_wr;
+wire [127:0] slot_crc;
+wire [127:0] slot_crc_bytes;
+
+sdram_arbiter sdram_arb (
+    .clk_74a(clk_74a),
+    .clk(clk),
+    .bridge_share(sdram_bridge_share),
+    // APF bridge
+    .bridge_addr(bridge_addr),
+    .bridge_rd(bridge_rd),
+    .bridge_wr(bridge_wr),
+    .bridge_wr_data(bridge_wr_data),
+    .bridge_rd_data(ram1_bridge_rd_data),
+    // CPU
+    .cpu_rd(cpu_sdram_rd),
+    .cpu_wr(cpu_sdram_wr),
+    .cpu_addr(cpu_sdram_addr),
+    .cpu_wdata(cpu_sdram_wdata),
+    .cpu_rdata(cpu_sdram_rdata),
+    .cpu_busy(cpu_sdram_busy),
+    .cpu_rdata_valid(cpu_sdram_rdata_valid),
+    // io_sdram word interface
+    .word_rd(sdram_rd),
+    .word_wr(sdram_wr),
+    .word_addr(sdram_addr),
+    .word_data(sdram_wdata),
+    .word_q(sdram_rdata),
+    .word_busy(sdram_busy),
+    .word_q_valid(sdram_rdata_valid),
+    .bridge_word_wr(sdram_bridge_word_wr),
+    // Status counters
+    .stat_cpu_ops(sdram_arb_cpu_ops),
+    .stat_bridge_ops(sdram_arb_bridge_ops),
+    .stat_cpu_wait(sdram_arb_cpu_wait),
+    .stat_bridge_wait(sdram_arb_bridge_wait),
+    .stat_bridge_fifo_max(sdram_arb_bridge_fifo_max),
+    .stat_bridge_fifo_overflow(sdram_arb_bridge_overflow)
+);
+
+dataslot_crc dslot_crc (
+    .clk_74a(clk_74a),
+    .clk(clk),
+    .dataslot_requestwrite(dataslot_requestwrite),
+    .dataslot_requestwrite_id(dataslot_requestwrite_id),
+    .dataslot_requestwrite_size(dataslot_requestwrite_size),
+    .bridge_word_wr(sdram_bridge_word_wr),
+    .bridge_word_addr(sdram_addr),
+    .bridge_word_data(sdram_wdata),
+    .slot_crc(slot_crc),
+    .slot_bytes(slot_crc_bytes)
+);
+
+// ============================================
+// CPU system
+// ============================================
+// CPU reset as in core_top: restarts on Reset Enter, runs through the load
+reg [2:0] cpu_host_reset_sync = 3'b111;
+reg [3:0] cpu_reset_count = 4'hF;
+assign cpu_reset_n = cpu_reset_count == 4'h0;
+
+always @(posedge clk) begin
+    cpu_host_reset_sync <= {cpu_host_reset_sync[1:0], reset_n};
+    if (!pll_core_locked || (cpu_host_reset_sync[2] && !cpu_host_reset_sync[1]))
+        cpu_reset_count <= 4'hF;
+    else if (cpu_reset_count != 4'h0)
+        cpu_reset_count <= cpu_reset_count - 4'h1;
+end
+
+cpu_system #(
+    .SPLIT_BUS(SPLIT_BUS)
+) cpu (
+    .clk(clk),
+    .reset_n(cpu_reset_n),
+    .dataslot_allcomplete(dataslot_allcomplete),
+    .host_reset_n(reset_n),
+    // Terminal interface
+    .term_mem_valid(term_mem_valid),
+    .term_mem_addr(term_mem_addr),
+    .term_mem_wdata(term_mem_wdata),
+    .term_mem_wstrb(term_mem_wstrb),
+    .term_mem_rdata(term_mem_rdata),
+    .term_mem_ready(term_mem_ready),
+    // SDRAM interface
+    .sdram_rd(cpu_sdram_rd),
+    .sdram_wr(cpu_sdram_wr),
+    .sdram_addr(cpu_sdram_addr),
+    .sdram_wdata(cpu_sdram_wdata),
+    .sdram_rdata(cpu_sdram_rdata),
+    .sdram_busy(cpu_sdram_busy),
+    .sdram_rdata_valid(cpu_sdram_rdata_valid),
+    // SDRAM arbiter control/status
+    .sdram_bridge_share(sdram_bridge_share),
+    .sdram_arb_cpu_ops(sdram_arb_cpu_ops),
+    .sdram_arb_bridge_ops(sdram_arb_bridge_ops),
+    .sdram_arb_cpu_wait(sdram_arb_cpu_wait),
+    .sdram_arb_bridge_wait(sdram_arb_bridge_wait),
+    .sdram_arb_bridge_fifo_max(sdram_arb_bridge_fifo_max),
+    .sdram_arb_bridge_overflow(sdram_arb_bridge_overflow),
+    // Data slot CRC32
+    .slot_crc(slot_crc),
+    .slot_crc_bytes(slot_crc_bytes),
+    // PSRAM interface
+    .psram_rd(psram_rd),
+    .psram_wr(psram_wr),
+    .psram_addr(psram_addr),
+    .psram_wdata(psram_wdata),
+    .psram_rdata(psram_rdata),
+    .psram_busy(psram_busy)
+);
+
+endmodule
@@ -0,0 +1,224 @@
+/*
+ * Approximate attention accuracy/speed report (host build)
+ *
+ * Runs the firmware's fp32 forward() with exact attention and with the
+ * two-stage approximate attention from src/firmware/attn.h (int4 key shadow,
+ * top k + recent window rescored exactly) on a llama2.c model.bin, along the
+ * exact greedy sequence from BOS, and prints a markdown report:
+ *   - at pos 256 and 512 (clamped to seq_len - 1): logits error, top-1, and
+ *     the KV words and float ops attention needs, per k
+ *   - over every position from 64: mean/min logits cosine and top-1 agreement
+ *
+ * Build and run:
+ *   make attn-report
+ *   gcc -O2 -Isrc/firmware -o tools/attn_report tools/attn_report.c -lm
+ *   tools/attn_report dist/assets/model.bin [window]
+ */
+
+#include "host_model.h"
+#include "attn.h"
+
+/* Key shadow and counters, per State (State.user) */
+typedef struct {
+    int topk;           /* 0: exact attention */
+    uint32_t* key_shadow;
+    uint32_t* key_shadow_scale;
+    int* sel;
+    int32_t* sel_score;
+    int16_t* qq;
+    long kv_reads;      /* words read from the KV cache and shadow by attention */
+    long fp_ops;        /* float add/mul/exp in attention (soft-float on VexRiscv) */
+} AttnRun;
+
+/* k values under test and report positions */
+static const int topks[] = { 8, 16, 32, 64 };
+#define N_TOPK ((int)(sizeof(topks) / sizeof(topks[0])))
+static const int report_pos[] = { 256, 512 };
+#define N_POS ((int)(sizeof(report_pos) / sizeof(report_pos[0])))
+#define SWEEP_FROM  64      /* first position of the all-positions sweep */
+
+static int window = 16;
+
+/* ============================================
+ * Attention (as in the firmware)
+ * ============================================ */
+
+/* attention hook: shadow the new keys, then exact or approximate per head */
+static void attn_layer(Model* m, State* s, int l, int pos) {
+    AttnRun* r = s->user;
+    Config* p = &m->c;
+    int head_size = p->dim / p->n_heads;
+    int kv_dim = (p->dim * p->n_kv_heads) / p->n_heads;
+    int kv_mul = p->n_heads / p->n_kv_heads;
+    int sw = attn_shadow_words(head_size);
+    long loff = (long)l * p->seq_len * kv_dim;
+    float* k = s->key_cache + loff + pos * kv_dim;
+
+    long soff = ((long)l * p->seq_len + pos) * p->n_kv_heads;
+    for (int g = 0; g < p->n_kv_heads; g++) {
+        attn_shadow_key(r->key_shadow + (soff + g) * sw, r->key_shadow_scale + soff + g,
+                        k + g * head_size, head_size);
+    }
+    soff -= (long)pos * p->n_kv_heads;
+
+    for (int h = 0; h < p->n_heads; h++) {
+        if (r->topk > 0) {
+            int g = h / kv_mul;
+            AttnHead a = {
+                s->key_cache + loff + g * head_size, s->value_cache + loff + g * head_size, kv_dim,
+                r->key_shadow + (soff + g) * sw, r->key_shadow_scale + soff + g,
+                p->n_kv_heads * sw, p->n_kv_heads, head_size
+            };
+            attn_query(r->qq, s->q + h * head_size, head_size);
+            int n = attn_head_approx(s->xb + h * head_size, s->q + h * head_size, r->qq, &a, pos,
+                                     r->topk, window, r->sel, r->sel_score, s->att + h * p->seq_len);
+            int recent = pos + 1 - window;
+            int scanned = recent > r->topk ? recent : 0;
+            r->kv_reads += (long)scanned * (sw + 1) + 2L * n * head_size;
+            r->fp_ops += 2L * scanned + (4L * head_size + 3) * n;
+            continue;
+        }
+        attention_head(m, s, l, h, pos);
+        r->kv_reads += 2L * (pos + 1) * head_size;
+        r->fp_ops += (4L * head_size + 3) * (pos + 1);
+    }
+}
+
+static void alloc_run(State* s, AttnRun* r, const Config* p) {
+    int head_size = p->dim / p->n_heads;
+    long shadow = (long)p->n_layers * p->seq_len * p->n_kv_heads;
+    int max_sel = topks[N_TOPK - 1] + window;
+    alloc_state(s, p);
+    memset(r, 0, sizeof(*r));
+    r->key_shadow = xcalloc(shadow * attn_shadow_words(head_size), sizeof(uint32_t));
+    r->key_shadow_scale = xcalloc(shadow, sizeof(uint32_t));
+    r->sel = xcalloc(max_sel, sizeof(int));
+    r->sel_score = xcalloc(max_sel, sizeof(int32_t));
+    r->qq = xcalloc(attn_shadow_words(head_size) * 8, sizeof(int16_t));
+    s->attention = attn_layer;
+    s->user = r;
+}
+
+/* topk 0: exact attention */
+static float* forward_topk(Model* m, State* s, int token, int pos, int topk) {
+    ((AttnRun*)s->user)->topk = topk;
+    return forward(m, s, token, pos);
+}
+
+/* ============================================
+ * Report
+ * ============================================ */
+
+static double cosine(const float* a, const float* b, int n) {
+    double dot = 0.0, na = 0.0, nb = 0.0;
+    for (int i = 0; i < n; i++) {
+        dot += (double)a[i] * b[i];
+        na += (double)a[i] * a[i];
+        nb += (double)b[i] * b[i];
+    }
+    return dot / (sqrt(na * nb) + 1e-30);
+}
+
+static double max_abs_err(const float* a, const float* b, int n) {
+    double e = 0.0;
+    for (int i = 0; i < n; i++) {
+        double d = fabs((double)a[i] - b[i]);
+        if (d > e) e = d;
+    }
+    return e;
+}
+
+/* forward() at pos, counting attention KV words and float ops */
+static float* measure(Model* m, State* s, int token, int pos, int topk, long* reads, long* ops) {
+    AttnRun* r = s->user;
+    r->kv_reads = 0;
+    r->fp_ops = 0;
+    float* logits = forward_topk(m, s, token, pos, topk);
+    *reads = r->kv_reads;
+    *ops = r->fp_ops;
+    return logits;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s model.bin [window]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 2) window = atoi(argv[2]);
+    Model m;
+    load_model(&m, argv[1]);
+    if (m.pruned || m.factorized) {
+        fprintf(stderr, "%s: pruned or factorized model not supported\n", argv[1]);
+        return 1;
+    }
+    Config* p = &m.c;
+    int V = p->vocab_size;
+    int last = p->seq_len - 1;
+
+    /* Exact greedy decode from BOS fills the KV cache and shadow for every position */
+    State s;
+    AttnRun run;
+    alloc_run(&s, &run, p);
+    int* tokens = xcalloc(p->seq_len + 1, sizeof(int));
+    float* exact = xcalloc((long)p->seq_len * V, sizeof(float));
+    tokens[0] = 1;
+    for (int pos = 0; pos <= last; pos++) {
+        float* logits = forward_topk(&m, &s, tokens[pos], pos, 0);
+        memcpy(exact + (long)pos * V, logits, V * sizeof(float));
+        tokens[pos + 1] = argmax(logits, V);
+    }
+
+    printf("# Approximate attention\n\n");
+    printf("`%s`: dim=%d layers=%d heads=%d kv_heads=%d head_size=%d seq_len=%d, exact greedy decode from BOS.\n\n",
+           argv[1], p->dim, p->n_layers, p->n_heads, p->n_kv_heads, p->dim / p->n_heads, p->seq_len);
+    printf("Keys shadowed in int4 (one fixed-point scale per position and kv head), top k by shadow score plus the "
+           "last %d positions rescored exactly; the KV cache before each position is the exact one. "
+           "KV reads are the words attention loads from the KV cache and shadow (PSRAM on the Pocket), "
+           "float ops its fp32 add/mul/exp, which are soft-float calls on VexRiscv. Stage 1 scores (int4 x int8 dot "
+           "product times the integer scale) and the top-k selection are int32; the only float work outside "
+           "stage 2 is quantizing the query once per head. "
+           "Host wall time is not reported: the host has an FPU. For cycles on the target see "
+           "`fwd_approx_pos*_cyc` in `make sim`.\n\n", window);
+
+    for (int i = 0; i < N_POS; i++) {
+        int pos = report_pos[i] < last ? report_pos[i] : last;
+        long exact_reads, exact_ops;
+        measure(&m, &s, tokens[pos], pos, 0, &exact_reads, &exact_ops);
+        const float* r = exact + (long)pos * V;
+
+        printf("## pos %d\n\n", pos);
+        printf("| k | Logits cosine | Max abs error | Top-1 | KV reads | Float ops | KV read speedup | Float op speedup |\n");
+        printf("|---:|---:|---:|:---:|---:|---:|---:|---:|\n");
+        printf("| exact | 1.000000 | 0.0000 | yes | %ld | %ld | 1.00x | 1.00x |\n", exact_reads, exact_ops);
+        for (int k = 0; k < N_TOPK; k++) {
+            long reads, ops;
+            float* logits = measure(&m, &s, tokens[pos], pos, topks[k], &reads, &ops);
+            printf("| %d | %.6f | %.4f | %s | %ld | %ld | %.2fx | %.2fx |\n", topks[k],
+                   cosine(logits, r, V), max_abs_err(logits, r, V),
+                   argmax(logits, V) == tokens[pos + 1] ? "yes" : "no",
+                   reads, ops, (double)exact_reads / reads, (double)exact_ops / ops);
+        }
+        /* Restore the exact cache entry at pos */
+        forward_topk(&m, &s, tokens[pos], pos, 0);
+        printf("\n");
+    }
+
+    if (last < SWEEP_FROM) return 0;
+    printf("## Every position from %d to %d\n\n", SWEEP_FROM, last);
+    printf("| k | Logits cosine, mean | Logits cosine, min | Top-1 agreement |\n|---:|---:|---:|---:|\n");
+    for (int k = 0; k < N_TOPK; k++) {
+        double cos_mean = 0.0, cos_min = 1.0;
+        int agree = 0, n = 0;
+        for (int pos = SWEEP_FROM; pos <= last; pos++) {
+            float* logits = forward_topk(&m, &s, tokens[pos], pos, topks[k]);
+            double c = cosine(logits, exact + (long)pos * V, V);
+            cos_mean += c;
+            if (c < cos_min) cos_min = c;
+            agree += argmax(logits, V) == tokens[pos + 1];
+            n++;
+            forward_topk(&m, &s, tokens[pos], pos, 0);
+        }
+        printf("| %d | %.6f | %.6f | %.1f%% |\n", topks[k], cos_mean / n, cos_min, 100.0 * agree / n);
+    }
+    return 0;
+}
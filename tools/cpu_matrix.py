@@ -0,0 +1,314 @@
+#!/usr/bin/env python3
+"""
+VexRiscv configuration benchmark matrix.
+
+For every variant in tools/cpu_variants.json:
+  1. take the checked-in VexRiscv_*.v, or generate one with
+     src/fpga/vexriscv/gen/PocketVexRiscv.scala (needs sbt + a VexRiscv checkout
+     at --vexriscv-ref built on the same SpinalHDL as the checked-in files)
+  2. run the RUN_BENCH firmware on it in the Verilator harness (src/sim)
+     with the same cpu_system.v wrapper and memory models, timing positions
+     up to --bench-max-pos only
+  3. collect forward() cycles/token and soft-float op costs
+  4. count cache / register file M10Ks from the geometry, or measure
+     ALMs / M10K / DSP with --quartus (map + fit)
+and print a markdown comparison table.
+
+Usage:
+    ./tools/cpu_matrix.py --vexriscv-ref REF   # all variants
+    ./tools/cpu_matrix.py --only full,min      # checked-in variants, no checkout
+    ./tools/cpu_matrix.py --skip-sim           # resources only
+    ./tools/cpu_matrix.py --quartus            # real fit numbers (slow)
+    ./tools/cpu_matrix.py --out docs/cpu-matrix.md
+
+There is no ALM model: without --quartus only the M10K count from the cache
+and register file geometry is reported, and ALM / DSP columns stay empty.
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
+SIM_DIR = os.path.join(ROOT, 'src', 'sim')
+GEN_SCALA = os.path.join(ROOT, 'src', 'fpga', 'vexriscv', 'gen', 'PocketVexRiscv.scala')
+VEXRISCV_URL = 'https://github.com/SpinalHDL/VexRiscv.git'
+REFERENCE_V = os.path.join(ROOT, 'src', 'fpga', 'vexriscv', 'VexRiscv_Full.v')
+BENCH_POSITIONS = (64, 128, 256, 511)  # bench_positions in llama_embedded.c
+
+def firmware_define(name, header='src/firmware/libc/libc.h'):
+    """Integer value of a #define in a firmware header, so the tools and the
+    firmware share one copy of each constant."""
+    with open(os.path.join(ROOT, header)) as f:
+        m = re.search(r'^#define\s+%s\s+\(?(0x[0-9A-Fa-f]+|\d+)' % name, f.read(), re.M)
+    if not m:
+        raise ValueError('%s: no #define %s' % (header, name))
+    return int(m.group(1), 0)
+
+
+CPU_MHZ = firmware_define('CPU_HZ') / 1e6
+
+# Generator defaults (must match PocketVexRiscv.Options)
+DEFAULT_OPTIONS = {
+    'bypass': 1,
+    'prediction': 'static',
+    'mul': 'pipelined',
+    'mul-unroll': 1,
+    'div-unroll': 1,
+    'icache': 4096,
+    'dcache': 4096,
+    'ways': 1,
+    'line': 32,
+    'shifter': 'barrel',
+}
+
+
+def run(cmd, cwd=None, log=None):
+    """Run a command, echoing it; returns True on success."""
+    print('+ ' + ' '.join(cmd), file=sys.stderr)
+    if log is None:
+        return subprocess.run(cmd, cwd=cwd).returncode == 0
+    with open(log, 'w') as out:
+        return subprocess.run(cmd, cwd=cwd, stdout=out, stderr=subprocess.STDOUT).returncode == 0
+
+
+# ============================================
+# Verilog generation
+# ============================================
+
+def spinal_version(verilog):
+    """SpinalHDL version from the 'Generator :' header of a generated file."""
+    with open(verilog) as f:
+        m = re.search(r'Generator\s*:\s*SpinalHDL v(\S+)', f.readline())
+    return m.group(1) if m else None
+
+
+def ensure_vexriscv(path, ref, want_spinal):
+    """Check out ref and make sure it builds with SpinalHDL want_spinal, so
+    generated variants compare against the checked-in ones like for like."""
+    if not ref:
+        print('ERROR: generated variants need --vexriscv-ref: a VexRiscv tag or commit whose '
+              'build.sbt uses SpinalHDL %s (the version in %s)'
+              % (want_spinal, os.path.relpath(REFERENCE_V, ROOT)), file=sys.stderr)
+        return False
+    if not os.path.isdir(path) and not run(['git', 'clone', VEXRISCV_URL, path]):
+        return False
+    if not run(['git', 'checkout', '--detach', ref], cwd=path):
+        return False
+    with open(os.path.join(path, 'build.sbt')) as f:
+        m = re.search(r'spinalVersion\s*=\s*"([^"]+)"', f.read())
+    if not m or m.group(1) != want_spinal:
+        print('ERROR: VexRiscv %s uses SpinalHDL %s, the checked-in variants %s'
+              % (ref, m.group(1) if m else '(unknown)', want_spinal), file=sys.stderr)
+        return False
+    demo_dir = os.path.join(path, 'src', 'main', 'scala', 'vexriscv', 'demo')
+    shutil.copy(GEN_SCALA, demo_dir)
+    return True
+
+
+def generate(variant, vexriscv_dir, out_dir):
+    name = 'VexRiscv_' + variant['name']
+    verilog = os.path.join(out_dir, name + '.v')
+    if os.path.exists(verilog):
+        return verilog
+    os.makedirs(out_dir, exist_ok=True)
+    args = ['--name=' + name, '--target=' + out_dir]
+    args += ['--%s=%s' % (k, v) for k, v in variant['options'].items()]
+    cmd = ['sbt', 'runMain vexriscv.demo.PocketVexRiscv ' + ' '.join(args)]
+    if not run(cmd, cwd=vexriscv_dir, log=os.path.join(out_dir, 'gen.log')):
+        return None
+    return verilog
+
+
+# ============================================
+# Simulation
+# ============================================
+
+def simulate(variant, verilog, timeout, max_pos):
+    build = os.path.join('build', 'matrix', variant['name'])
+    defines = ['-DRUN_BENCH=1', '-DSIM_CONSOLE', '-DBENCH_MAX_POS=%d' % max_pos]
+    defines += variant.get('fw_defines', [])
+    fw_make = ' '.join('%s=%s' % kv for kv in variant.get('fw_make', {}).items())
+    cmd = ['make', '-C', SIM_DIR, 'run',
+           'CPU=' + variant['name'],
+           'CPU_V=' + verilog,
+           'BUILD=' + build,
+           'FW_DEFINES=' + ' '.join(defines),
+           'FW_MAKEFLAGS=' + fw_make,
+           'SIM_ARGS=--max-cycles %d' % timeout]
+    log = os.path.join(SIM_DIR, build + '.log')
+    os.makedirs(os.path.dirname(log), exist_ok=True)
+    run(cmd, log=log)
+    return parse_bench(os.path.join(SIM_DIR, build, 'bench.log'))
+
+
+def parse_bench(path):
+    """BENCH key=value pairs; 'done' is set only if the run got to the end."""
+    results = {}
+    if not os.path.exists(path):
+        return results
+    with open(path) as f:
+        for line in f:
+            if line.strip() == 'BENCH done':
+                results['done'] = 1
+            elif line.startswith('BENCH '):
+                for key, value in re.findall(r'(\w+)=(-?\d+)', line):
+                    results[key] = int(value)
+    return results
+
+
+# ============================================
+# Resources
+# ============================================
+
+def m10k_blocks(depth, width):
+    """M10K blocks for a depth x width RAM, best Cyclone V aspect ratio."""
+    if depth == 0 or width == 0:
+        return 0
+    modes = [(256, 40), (512, 20), (1024, 10), (2048, 5), (4096, 2), (8192, 1)]
+    return min(math.ceil(depth / d) * math.ceil(width / w) for d, w in modes)
+
+
+def estimate_resources(options):
+    """M10K blocks of the caches and register file from their geometry (CPU
+    only); ALMs and DSPs need --quartus."""
+    o = dict(DEFAULT_OPTIONS, **options)
+
+    m10k = 2 * m10k_blocks(32, 32)  # register file, one copy per read port
+    for size in (o['icache'], o['dcache']):
+        if size == 0:
+            continue
+        lines_per_way = size // o['line'] // o['ways']
+        tag_width = 32 - int(math.log2(size // o['ways'])) + 1
+        m10k += o['ways'] * m10k_blocks(lines_per_way, tag_width)
+        m10k += o['ways'] * m10k_blocks(size // 4 // o['ways'], 32)
+    if o['prediction'] in ('dynamic', 'dynamic_target'):
+        m10k += 1  # branch history table
+    return {'alms': None, 'm10k': m10k, 'dsp': None, 'source': 'geometry'}
+
+
+def quartus_resources(verilog):
+    """Map + fit the full core with this CPU and read the fit summary."""
+    if not shutil.which('quartus_map'):
+        return None
+    fpga = os.path.join(ROOT, 'src', 'fpga')
+    with tempfile.TemporaryDirectory() as tmp:
+        work = os.path.join(tmp, 'fpga')
+        shutil.copytree(fpga, work, ignore=shutil.ignore_patterns('db', 'incremental_db', 'output_files'))
+        qsf = os.path.join(work, 'ap_core.qsf')
+        with open(qsf) as f:
+            text = f.read()
+        text = text.replace('vexriscv/VexRiscv_Full.v', os.path.abspath(verilog))
+        with open(qsf, 'w') as f:
+            f.write(text)
+        if not (run(['quartus_map', 'ap_core'], cwd=work) and run(['quartus_fit', 'ap_core'], cwd=work)):
+            return None
+        with open(os.path.join(work, 'output_files', 'ap_core.fit.summary')) as f:
+            summary = f.read()
+    if not re.search(r'Fitter Status\s*:\s*Successful', summary):
+        print('WARNING: %s: fit did not succeed, no resource numbers' % verilog, file=sys.stderr)
+        return None
+
+    def field(name):
+        m = re.search(re.escape(name) + r'\s*:\s*([\d,]+)', summary)
+        return int(m.group(1).replace(',', '')) if m else None
+
+    return {'alms': field('Logic utilization (in ALMs)'),
+            'm10k': field('Total RAM Blocks'),
+            'dsp': field('Total DSP Blocks'),
+            'source': 'fit (core total)'}
+
+
+# ============================================
+# Report
+# ============================================
+
+def fmt(v):
+    return '-' if v is None else '{:,}'.format(v)
+
+
+def report(rows, max_pos):
+    pos = max([p for p in BENCH_POSITIONS if p <= max_pos], default=None)
+    out = []
+    out.append('| Variant | Description | fadd | fmul | fdiv | expf | fwd cyc/tok | fwd @pos%s | tok/min @%.0fMHz '
+               '| ALMs | M10K | DSP |' % (pos if pos else '-', CPU_MHZ))
+    out.append('|---|---|---:|---:|---:|---:|---:|---:|---:|---:|---:|---:|')
+    for v, bench, res in rows:
+        cyc = bench.get('fwd_avg_cyc')
+        tpm = int(CPU_MHZ * 1e6 * 60 / cyc) if cyc else None
+        src = ' *' if res['source'] != 'geometry' else ''
+        name = v['name'] if not bench or bench.get('done') else v['name'] + ' (incomplete)'
+        out.append('| %s | %s | %s | %s | %s | %s | %s | %s | %s | %s%s | %s | %s |' % (
+            name, v.get('desc', ''),
+            fmt(bench.get('fadd_cyc')), fmt(bench.get('fmul_cyc')),
+            fmt(bench.get('fdiv_cyc')), fmt(bench.get('expf_cyc')),
+            fmt(cyc), fmt(bench.get('fwd_pos%d_cyc' % pos) if pos else None), fmt(tpm),
+            fmt(res['alms']), src, fmt(res['m10k']), fmt(res['dsp'])))
+    out.append('')
+    out.append('Soft-float columns are cycles/op. Without * the M10K column counts the CPU caches and '
+               'register file from their geometry and ALMs/DSPs are not estimated; * is a Quartus fit '
+               'of the whole core. "incomplete" runs hit --max-cycles before the end of the benchmark.')
+    return '\n'.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='VexRiscv configuration benchmark matrix')
+    parser.add_argument('--variants', default=os.path.join(ROOT, 'tools', 'cpu_variants.json'))
+    parser.add_argument('--only', help='comma-separated variant names')
+    parser.add_argument('--vexriscv-dir', default=os.path.join(SIM_DIR, 'build', 'VexRiscv'))
+    parser.add_argument('--vexriscv-ref', help='VexRiscv tag or commit for generated variants '
+                        '(must build with the SpinalHDL of the checked-in VexRiscv_Full.v)')
+    parser.add_argument('--skip-sim', action='store_true', help='resources only')
+    parser.add_argument('--quartus', action='store_true', help='measure resources with quartus_map/fit')
+    parser.add_argument('--bench-max-pos', type=int, default=64, choices=(0,) + BENCH_POSITIONS,
+                        help='last position timed (BENCH_MAX_POS); each one costs a decode up to it')
+    parser.add_argument('--max-cycles', type=int, default=20000000000)
+    parser.add_argument('--out', help='also write the table to this file')
+    args = parser.parse_args()
+
+    with open(args.variants) as f:
+        variants = json.load(f)['variants']
+    if args.only:
+        wanted = set(args.only.split(','))
+        variants = [v for v in variants if v['name'] in wanted]
+
+    gen_dir = os.path.join(SIM_DIR, 'build', 'gen')
+    have_vexriscv = None  # checkout attempted lazily, once
+    rows = []
+    for v in variants:
+        if 'verilog' in v:
+            verilog = os.path.join(ROOT, v['verilog'])
+        else:
+            if have_vexriscv is None:
+                have_vexriscv = ensure_vexriscv(args.vexriscv_dir, args.vexriscv_ref, spinal_version(REFERENCE_V))
+            verilog = generate(v, args.vexriscv_dir, os.path.join(gen_dir, v['name'])) if have_vexriscv else None
+            if verilog and spinal_version(verilog) != spinal_version(REFERENCE_V):
+                print('WARNING: %s: generated by SpinalHDL %s, not %s' % (
+                    v['name'], spinal_version(verilog), spinal_version(REFERENCE_V)), file=sys.stderr)
+                verilog = None
+            if not verilog:
+                print('WARNING: %s: generation failed, skipping' % v['name'], file=sys.stderr)
+                continue
+
+        bench = {} if args.skip_sim else simulate(v, verilog, args.max_cycles, args.bench_max_pos)
+        res = (quartus_resources(verilog) if args.quartus else None) or estimate_resources(v['options'])
+        rows.append((v, bench, res))
+
+    table = report(rows, args.bench_max_pos)
+    print(table)
+    if args.out:
+        with open(args.out, 'w') as f:
+            f.write('# VexRiscv configuration matrix\n\n')
+            f.write('Generated by `tools/cpu_matrix.py --bench-max-pos %d`%s.\n\n' % (
+                args.bench_max_pos, ', VexRiscv ' + args.vexriscv_ref if args.vexriscv_ref else ''))
+            f.write(table + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+"""
+Random-weight llama2.c checkpoints for benchmarking at arbitrary shapes.
+
+Writes model.bin and tokenizer.bin into the output directory, in the formats
+the firmware loads from the data slots:
+  model.bin      7 x int32 Config header, then fp32 weights in llama2.c order
+                 (negative vocab_size = unshared classifier), then the CRC32
+                 trailer checked against the slot load (tools/model_checksum.py).
+                 With --ffn-dims, hidden_dim is minus the widest layer and
+                 n_layers int32 FFN widths follow the header (tools/prune_ffn.c).
+                 With --rank, n_layers is negative and a rank per layer for
+                 wo, w1, w2, w3 follows; each of those layers is stored as
+                 V (rank x n) then U (d x rank) (tools/lowrank.c)
+  tokenizer.bin  int32 max_token_length, then {float score, int32 len, bytes}
+                 per token: <unk>, <s>, </s>, the 256 byte tokens <0xXX>,
+                 then random lowercase pieces up to the vocabulary size, then
+                 the same CRC32 trailer as model.bin
+
+Weights are uniform in [-scale, scale], RMSNorm weights are 1.0, so the
+output is gibberish but every op does the same work as a trained model.
+Only fp32 exists in the container; integer formats are built by the
+firmware at load time (see src/firmware/quant.h).
+
+Usage:
+    python3 tools/gen_model.py --preset stories15M --out build/stories15M
+    python3 tools/gen_model.py --dim 128 --hidden-dim 344 --layers 6 \\
+        --heads 8 --kv-heads 4 --vocab 1024 --seq-len 512 --out build/m1
+    python3 tools/gen_model.py --preset stories260K --ffn-dims 172,128,96,96,64 --out build/p1
+    python3 tools/gen_model.py --preset stories15M --rank 64 --out build/r1
+"""
+
+import argparse
+import array
+import math
+import os
+import random
+import struct
+import sys
+import zlib
+
+# Known llama2.c shapes: dim, hidden_dim, layers, heads, kv_heads, vocab, seq_len
+PRESETS = {
+    'stories260K': (64, 172, 5, 8, 4, 512, 512),
+    'stories15M': (288, 768, 6, 6, 6, 32000, 256),
+    'stories42M': (512, 1376, 8, 8, 8, 32000, 1024),
+    'stories110M': (768, 2048, 12, 12, 12, 32000, 1024),
+}
+
+CONFIG_FIELDS = ('dim', 'hidden_dim', 'layers', 'heads', 'kv_heads', 'vocab', 'seq_len')
+
+CHUNK = 1 << 20  # floats per write
+
+# model.bin and tokenizer.bin trailer: magic 'CR32', zlib CRC32 of everything before it
+CHECKSUM_MAGIC = 0x32335243
+CHECKSUM_BYTES = 8
+
+
+PROJS = ('wo', 'w1', 'w2', 'w3')     # may be factorized, in rank table order
+
+
+def proj_elems(c, name):
+    """Elements of one projection over all layers, dense or rank-r factors."""
+    total = 0
+    for l in range(c['layers']):
+        h = c['ffn_dims'][l] if c.get('ffn_dims') else c['hidden_dim']
+        d = h if name in ('w1', 'w3') else c['dim']
+        n = h if name == 'w2' else c['dim']
+        r = c['ranks'][l * len(PROJS) + PROJS.index(name)] if c.get('ranks') else 0
+        total += r * (d + n) if r else d * n
+    return total
+
+
+def tensor_sizes(c, shared):
+    """(name, element count) in checkpoint order, as memory_map_weights() reads them."""
+    head_size = c['dim'] // c['heads']
+    kv_dim = c['kv_heads'] * head_size
+    L = c['layers']
+    sizes = [
+        ('token_embedding_table', c['vocab'] * c['dim']),
+        ('rms_att_weight', L * c['dim']),
+        ('wq', L * c['dim'] * c['dim']),
+        ('wk', L * c['dim'] * kv_dim),
+        ('wv', L * c['dim'] * kv_dim),
+        ('wo', proj_elems(c, 'wo')),
+        ('rms_ffn_weight', L * c['dim']),
+        ('w1', proj_elems(c, 'w1')),
+        ('w2', proj_elems(c, 'w2')),
+        ('w3', proj_elems(c, 'w3')),
+        ('rms_final_weight', c['dim']),
+        ('freq_cis_real', c['seq_len'] * head_size // 2),
+        ('freq_cis_imag', c['seq_len'] * head_size // 2),
+    ]
+    if not shared:
+        sizes.append(('wcls', c['vocab'] * c['dim']))
+    return sizes
+
+
+def header_bytes(c):
+    return (7 * 4 + (4 * c['layers'] if c.get('ffn_dims') else 0)
+            + (4 * c['layers'] * len(PROJS) if c.get('ranks') else 0))
+
+
+def model_bytes(c, shared=True):
+    return header_bytes(c) + 4 * sum(n for _, n in tensor_sizes(c, shared)) + CHECKSUM_BYTES
+
+
+def read_config(path):
+    """(config dict, shared classifier) from a model.bin header."""
+    with open(path, 'rb') as f:
+        c = dict(zip(CONFIG_FIELDS, struct.unpack('<7i', f.read(28))))
+        factorized = c['layers'] < 0
+        c['layers'] = abs(c['layers'])
+        if c['hidden_dim'] < 0:
+            c['ffn_dims'] = list(struct.unpack('<%di' % c['layers'], f.read(4 * c['layers'])))
+            c['hidden_dim'] = max(c['ffn_dims'])
+        if factorized:
+            n = c['layers'] * len(PROJS)
+            c['ranks'] = list(struct.unpack('<%di' % n, f.read(4 * n)))
+    shared = c['vocab'] > 0
+    c['vocab'] = abs(c['vocab'])
+    return c, shared
+
+
+def tokenizer_end(data):
+    """Byte offset of the end of the token records in a tokenizer.bin image:
+    the checksum trailer, or the end of the data."""
+    pos = 4
+    while pos + 8 <= len(data):
+        magic, n = struct.unpack_from('<Ii', data, pos)
+        if pos + CHECKSUM_BYTES == len(data) and magic == CHECKSUM_MAGIC:
+            break
+        if n < 0 or pos + 8 + n > len(data):
+            break
+        pos += 8 + n
+    return pos
+
+
+def check_config(c):
+    if c['dim'] % c['heads']:
+        return 'dim must be a multiple of heads'
+    if c['heads'] % c['kv_heads']:
+        return 'heads must be a multiple of kv_heads'
+    if (c['dim'] // c['heads']) % 2:
+        return 'head size must be even (RoPE pairs)'
+    if c['vocab'] < 3:
+        return 'vocab must hold <unk>, <s> and </s>'
+    if c.get('ffn_dims') and len(c['ffn_dims']) != c['layers']:
+        return '--ffn-dims needs one width per layer'
+    if c.get('ffn_dims') and min(c['ffn_dims']) < 1:
+        return 'FFN widths must be positive'
+    if c.get('ranks') and min(c['ranks']) < 0:
+        return 'ranks must not be negative'
+    return None
+
+
+def write_model(path, c, shared, scale, rng):
+    head_size = c['dim'] // c['heads']
+    vocab = c['vocab'] if shared else -c['vocab']
+    crc = 0
+
+    def write(f, data):
+        nonlocal crc
+        crc = zlib.crc32(data, crc)
+        f.write(data)
+
+    ffn_dims = c.get('ffn_dims')
+    hidden = -max(ffn_dims) if ffn_dims else c['hidden_dim']
+    with open(path, 'wb') as f:
+        ranks = c.get('ranks')
+        layers = -c['layers'] if ranks else c['layers']
+        write(f, struct.pack('<7i', c['dim'], hidden, layers, c['heads'],
+                             c['kv_heads'], vocab, c['seq_len']))
+        if ffn_dims:
+            write(f, struct.pack('<%di' % len(ffn_dims), *ffn_dims))
+        if ranks:
+            write(f, struct.pack('<%di' % len(ranks), *ranks))
+        for name, count in tensor_sizes(c, shared):
+            if name.startswith('rms_'):
+                data = array.array('f', [1.0]) * count
+                write(f, data.tobytes())
+            elif name.startswith('freq_cis_'):
+                fn = math.cos if name.endswith('real') else math.sin
+                data = array.array('f', (
+                    fn(t / 10000.0 ** (2.0 * i / head_size))
+                    for t in range(c['seq_len']) for i in range(head_size // 2)))
+                write(f, data.tobytes())
+            else:
+                while count:
+                    n = min(count, CHUNK)
+                    data = array.array('f', (rng.uniform(-scale, scale) for _ in range(n)))
+                    write(f, data.tobytes())
+                    count -= n
+        f.write(struct.pack('<2I', CHECKSUM_MAGIC, crc & 0xFFFFFFFF))
+
+
+def tokenizer_pieces(vocab, rng):
+    pieces = [b'<unk>', b'\n<s>\n', b'\n</s>\n']
+    pieces += [('<0x%02X>' % b).encode() for b in range(256)]
+    pieces = pieces[:vocab]
+    seen = set(pieces)
+    letters = 'abcdefghijklmnopqrstuvwxyz'
+    while len(pieces) < vocab:
+        n = rng.randint(2, 8)
+        p = (' ' if rng.random() < 0.5 else '') + ''.join(rng.choice(letters) for _ in range(n))
+        p = p.encode()
+        if p not in seen:
+            seen.add(p)
+            pieces.append(p)
+    return pieces
+
+
+def write_tokenizer(path, c, rng):
+    pieces = tokenizer_pieces(c['vocab'], rng)
+    data = [struct.pack('<i', max(len(p) for p in pieces))]
+    for i, p in enumerate(pieces):
+        # Merges score by rank like sentencepiece; specials and bytes score 0
+        score = 0.0 if i < 259 else -float(i - 259)
+        data += [struct.pack('<fi', score, len(p)), p]
+    data = b''.join(data)
+    with open(path, 'wb') as f:
+        f.write(data)
+        f.write(struct.pack('<2I', CHECKSUM_MAGIC, zlib.crc32(data) & 0xFFFFFFFF))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='random-weight model.bin/tokenizer.bin for any Config')
+    parser.add_argument('--preset', choices=sorted(PRESETS), help='start from a known shape')
+    parser.add_argument('--dim', type=int)
+    parser.add_argument('--hidden-dim', type=int)
+    parser.add_argument('--layers', type=int)
+    parser.add_argument('--heads', type=int)
+    parser.add_argument('--kv-heads', type=int, help='default: heads')
+    parser.add_argument('--vocab', type=int)
+    parser.add_argument('--seq-len', type=int)
+    parser.add_argument('--ffn-dims', help='comma-separated FFN width per layer (pruned layout)')
+    parser.add_argument('--rank', type=int, help='store wo/w1/w2/w3 of every layer as rank-r factors')
+    parser.add_argument('--dtype', default='fp32', choices=['fp32'],
+                        help='weight type in the container (fp32 only; see module docstring)')
+    parser.add_argument('--unshared-classifier', action='store_true', help='write a separate wcls')
+    parser.add_argument('--scale', type=float, default=0.02, help='weights uniform in [-scale, scale]')
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--out', required=True, help='output directory')
+    args = parser.parse_args()
+
+    c = dict(zip(CONFIG_FIELDS, PRESETS[args.preset])) if args.preset else {}
+    for field in CONFIG_FIELDS:
+        value = getattr(args, field)
+        if value is not None:
+            c[field] = value
+    if 'kv_heads' not in c and 'heads' in c:
+        c['kv_heads'] = c['heads']
+    if args.ffn_dims:
+        c['ffn_dims'] = [int(v) for v in args.ffn_dims.split(',')]
+        c['hidden_dim'] = max(c['ffn_dims'])
+    if args.rank and 'layers' in c:
+        c['ranks'] = [args.rank] * (c['layers'] * len(PROJS))
+    missing = [f for f in CONFIG_FIELDS if f not in c]
+    if missing:
+        parser.error('missing --%s (or use --preset)' % ', --'.join(m.replace('_', '-') for m in missing))
+    err = check_config(c)
+    if err:
+        parser.error(err)
+
+    os.makedirs(args.out, exist_ok=True)
+    rng = random.Random(args.seed)
+    shared = not args.unshared_classifier
+    write_model(os.path.join(args.out, 'model.bin'), c, shared, args.scale, rng)
+    write_tokenizer(os.path.join(args.out, 'tokenizer.bin'), c, rng)
+    print('%s: %s, %.2f MB' % (args.out, ' '.join('%s=%d' % (f, c[f]) for f in CONFIG_FIELDS),
+                               model_bytes(c, shared) / 1e6), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
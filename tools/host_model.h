@@ -0,0 +1,623 @@
+/*
+ * llama2.c model on the host (tools)
+ *
+ * The model.bin loader and the firmware's fp32 forward() for the host tools
+ * (tools/quant_report.c, attn_report.c, prune_ffn.c, lowrank.c), plus the
+ * pieces they share around it: the firmware's encode() for text, token
+ * sampling, evaluation corpora and CRC32-trailed model.bin writing.
+ *
+ * Reads every layout build_transformer_from_memory() does: unshared
+ * classifier (negative vocab_size), per-layer FFN widths (negative
+ * hidden_dim, widths after the Config header), factorized wo/w1/w2/w3
+ * (negative n_layers, a rank per layer and projection after the widths),
+ * optional CRC32 trailer. Tools change what forward() does through the hooks
+ * in State; without hooks it is the firmware's fp32 path.
+ *
+ * Header-only like src/firmware/quant.h and attn.h. Needs -lm.
+ */
+
+#ifndef HOST_MODEL_H
+#define HOST_MODEL_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MODEL_CRC_MAGIC     0x32335243  /* "CR32", as tools/gen_model.py */
+#define HOST_MAX_RANK       256         /* LOWRANK_MAX_RANK in the firmware */
+
+typedef struct {
+    int dim;
+    int hidden_dim;
+    int n_layers;
+    int n_heads;
+    int n_kv_heads;
+    int vocab_size;
+    int seq_len;
+} Config;
+
+/* Weight tensors with a matmul, in forward() order */
+enum { T_WQ, T_WK, T_WV, T_WO, T_W1, T_W2, T_W3, T_WCLS, T_COUNT };
+static const char* const tensor_names[T_COUNT] = { "wq", "wk", "wv", "wo", "w1", "w2", "w3", "wcls" };
+
+/* Projections that may be factorized, in rank table order (T_WO + k) */
+enum { PROJ_WO, PROJ_W1, PROJ_W2, PROJ_W3, PROJ_COUNT };
+static const char* const proj_names[PROJ_COUNT] = { "wo", "w1", "w2", "w3" };
+
+/* As in the firmware: dense d x n (v == NULL), or U (d x rank) and V (rank x n) */
+typedef struct {
+    float* w;
+    float* v;
+    int rank;
+} Proj;
+
+typedef struct Model {
+    Config c;                   /* hidden_dim: widest layer; vocab_size, n_layers positive */
+    int shared_weights;
+    int pruned;                 /* per-layer FFN widths in the file */
+    int factorized;             /* rank table in the file */
+    int* ffn_dim;               /* width of layer l */
+    int* ffn_off;               /* first row of layer l in w1/w3, ffn_off[L] = total */
+    Proj* proj;                 /* [n_layers * PROJ_COUNT] */
+    float* token_embedding_table;
+    float* rms_att_weight;
+    float *wq, *wk, *wv;
+    float* rms_ffn_weight;
+    float* rms_final_weight;
+    float* freq_cis;
+    float* wcls;
+} Model;
+
+typedef struct State State;
+
+struct State {
+    float *x, *xb, *xb2, *hb, *hb2, *q, *att, *logits;
+    float* t;                   /* rank-r intermediate of factorized projections */
+    float *key_cache, *value_cache;
+
+    /* Hooks, NULL for the firmware's fp32 path. matmul: xout = tensor of
+     * layer times x (matmul_tensor() is the default); attention: all heads
+     * of a layer into xb, with q and the KV cache at pos filled in
+     * (attention_head() per head is the default); ffn: sees
+     * silu(w1 x) * (w3 x) of each layer before w2. */
+    void (*matmul)(Model* m, State* s, int tensor, int layer, float* xout, const float* x, int n, int d);
+    void (*attention)(Model* m, State* s, int layer, int pos);
+    void (*ffn)(Model* m, State* s, int layer, const float* hb, int hidden_dim);
+    void* user;                 /* for the hooks */
+};
+
+static inline void* xcalloc(size_t n, size_t size) {
+    void* p = calloc(n, size);
+    if (!p) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static inline long file_size(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+/* ============================================
+ * Model
+ * ============================================ */
+
+static inline int layer_ffn(const Model* m, int l) {
+    return m->ffn_dim[l];
+}
+
+static inline void proj_shape(const Model* m, int l, int k, int* d, int* n) {
+    *d = (k == PROJ_W1 || k == PROJ_W3) ? layer_ffn(m, l) : m->c.dim;
+    *n = k == PROJ_W2 ? layer_ffn(m, l) : m->c.dim;
+}
+
+static inline long proj_elems(const Proj* pr, int d, int n) {
+    return pr->rank ? (long)pr->rank * (d + n) : (long)d * n;
+}
+
+static inline float* map_projs(Model* m, float* ptr, int k) {
+    for (int l = 0; l < m->c.n_layers; l++) {
+        Proj* pr = &m->proj[l * PROJ_COUNT + k];
+        int d, n;
+        proj_shape(m, l, k, &d, &n);
+        if (pr->rank) {
+            pr->v = ptr;
+            ptr += (long)pr->rank * n;
+            pr->w = ptr;
+            ptr += (long)d * pr->rank;
+        } else {
+            pr->v = NULL;
+            pr->w = ptr;
+            ptr += (long)d * n;
+        }
+    }
+    return ptr;
+}
+
+static inline void load_model(Model* m, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        exit(1);
+    }
+    if (fread(&m->c, sizeof(Config), 1, f) != 1) {
+        fprintf(stderr, "%s: short header\n", path);
+        exit(1);
+    }
+    Config* p = &m->c;
+    if (p->dim <= 0 || p->n_heads <= 0 || p->n_kv_heads <= 0 || p->dim % p->n_heads != 0 ||
+        p->n_heads % p->n_kv_heads != 0 || p->n_layers == 0 || p->hidden_dim == 0 ||
+        p->vocab_size == 0 || p->seq_len <= 0) {
+        fprintf(stderr, "%s: not a llama2.c model.bin (bad Config)\n", path);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f) - (long)sizeof(Config);
+    fseek(f, sizeof(Config), SEEK_SET);
+    float* data = xcalloc((size + sizeof(float) - 1) / sizeof(float), sizeof(float));
+    if (fread(data, 1, size, f) != (size_t)size) {
+        fprintf(stderr, "%s: short read\n", path);
+        exit(1);
+    }
+    fclose(f);
+
+    m->shared_weights = p->vocab_size > 0;
+    p->vocab_size = abs(p->vocab_size);
+    m->pruned = p->hidden_dim < 0;
+    m->factorized = p->n_layers < 0;
+    p->n_layers = abs(p->n_layers);
+    int head_size = p->dim / p->n_heads;
+    long L = p->n_layers;
+    long kv_dim = (long)p->n_kv_heads * head_size;
+
+    /* FFN widths, then ranks, follow the header (see the firmware loader) */
+    long tables = (m->pruned ? L : 0) + (m->factorized ? L * PROJ_COUNT : 0);
+    if (tables * (long)sizeof(int) > size) {
+        fprintf(stderr, "%s: %ld bytes, header tables need %ld\n", path, size + (long)sizeof(Config),
+                tables * (long)sizeof(int) + (long)sizeof(Config));
+        exit(1);
+    }
+    float* ptr = data;
+    m->ffn_dim = xcalloc(L, sizeof(int));
+    m->ffn_off = xcalloc(L + 1, sizeof(int));
+    if (m->pruned) {
+        memcpy(m->ffn_dim, ptr, L * sizeof(int));
+        ptr += L;
+        p->hidden_dim = 0;
+    }
+    for (int l = 0; l < L; l++) {
+        if (!m->pruned) m->ffn_dim[l] = p->hidden_dim;
+        if (m->ffn_dim[l] <= 0) {
+            fprintf(stderr, "%s: layer %d FFN width %d\n", path, l, m->ffn_dim[l]);
+            exit(1);
+        }
+        if (m->ffn_dim[l] > p->hidden_dim) p->hidden_dim = m->ffn_dim[l];
+        m->ffn_off[l + 1] = m->ffn_off[l] + m->ffn_dim[l];
+    }
+    m->proj = xcalloc(L * PROJ_COUNT, sizeof(Proj));
+    if (m->factorized) {
+        for (int i = 0; i < L * PROJ_COUNT; i++) {
+            m->proj[i].rank = ((int*)ptr)[i];
+            if (m->proj[i].rank < 0 || m->proj[i].rank > HOST_MAX_RANK) {
+                fprintf(stderr, "%s: projection rank %d (max %d)\n", path, m->proj[i].rank, HOST_MAX_RANK);
+                exit(1);
+            }
+        }
+        ptr += L * PROJ_COUNT;
+    }
+
+    /* Same layout as memory_map_weights() in the firmware */
+    m->token_embedding_table = ptr;  ptr += (long)p->vocab_size * p->dim;
+    m->rms_att_weight = ptr;         ptr += L * p->dim;
+    m->wq = ptr;                     ptr += L * p->dim * p->dim;
+    m->wk = ptr;                     ptr += L * p->dim * kv_dim;
+    m->wv = ptr;                     ptr += L * p->dim * kv_dim;
+    ptr = map_projs(m, ptr, PROJ_WO);
+    m->rms_ffn_weight = ptr;         ptr += L * p->dim;
+    ptr = map_projs(m, ptr, PROJ_W1);
+    ptr = map_projs(m, ptr, PROJ_W2);
+    ptr = map_projs(m, ptr, PROJ_W3);
+    m->rms_final_weight = ptr;       ptr += p->dim;
+    m->freq_cis = ptr;               ptr += p->seq_len * head_size;
+    m->wcls = m->shared_weights ? m->token_embedding_table : ptr;
+    if (!m->shared_weights) ptr += (long)p->vocab_size * p->dim;
+
+    /* The weights end the file, or are followed by the checksum trailer */
+    long need = (long)(ptr - data) * (long)sizeof(float);
+    int trailer = size == need + 8 && ((uint32_t*)data)[need / sizeof(float)] == MODEL_CRC_MAGIC;
+    if (size != need && !trailer) {
+        fprintf(stderr, "%s: %ld bytes, Config needs %ld (%ld with the checksum trailer)\n", path,
+                size + (long)sizeof(Config), need + (long)sizeof(Config), need + 8 + (long)sizeof(Config));
+        exit(1);
+    }
+}
+
+static inline void alloc_state(State* s, const Config* p) {
+    int kv_dim = (p->dim * p->n_kv_heads) / p->n_heads;
+    long cache = (long)p->n_layers * p->seq_len * kv_dim;
+    memset(s, 0, sizeof(*s));
+    s->x = xcalloc(p->dim, sizeof(float));
+    s->xb = xcalloc(p->dim, sizeof(float));
+    s->xb2 = xcalloc(p->dim, sizeof(float));
+    s->hb = xcalloc(p->hidden_dim, sizeof(float));
+    s->hb2 = xcalloc(p->hidden_dim, sizeof(float));
+    s->q = xcalloc(p->dim, sizeof(float));
+    s->att = xcalloc((long)p->n_heads * p->seq_len, sizeof(float));
+    s->logits = xcalloc(p->vocab_size, sizeof(float));
+    s->t = xcalloc(HOST_MAX_RANK, sizeof(float));
+    s->key_cache = xcalloc(cache, sizeof(float));
+    s->value_cache = xcalloc(cache, sizeof(float));
+}
+
+/* ============================================
+ * Forward pass (as in the firmware)
+ * ============================================ */
+
+static inline void rmsnorm(float* o, const float* x, const float* weight, int size) {
+    float ss = 0.0f;
+    for (int j = 0; j < size; j++) ss += x[j] * x[j];
+    ss /= size;
+    ss += 1e-5f;
+    ss = 1.0f / sqrtf(ss);
+    for (int j = 0; j < size; j++) o[j] = weight[j] * (ss * x[j]);
+}
+
+static inline void softmax(float* x, int size) {
+    float max_val = x[0];
+    for (int i = 1; i < size; i++) if (x[i] > max_val) max_val = x[i];
+    float sum = 0.0f;
+    for (int i = 0; i < size; i++) {
+        x[i] = expf(x[i] - max_val);
+        sum += x[i];
+    }
+    for (int i = 0; i < size; i++) x[i] /= sum;
+}
+
+static inline void matmul(float* xout, const float* x, const float* w, int n, int d) {
+    for (int i = 0; i < d; i++) {
+        float val = 0.0f;
+        for (int j = 0; j < n; j++) val += w[(long)i * n + j] * x[j];
+        xout[i] = val;
+    }
+}
+
+/* matmul_proj() in the firmware: factorized projections go through s->t */
+static inline void matmul_proj(State* s, float* xout, const float* x, const Proj* pr, int n, int d) {
+    if (pr->rank) {
+        matmul(s->t, x, pr->v, n, pr->rank);
+        matmul(xout, s->t, pr->w, pr->rank, d);
+    } else {
+        matmul(xout, x, pr->w, n, d);
+    }
+}
+
+/* xout = tensor of layer (d x n) times x, fp32 */
+static inline void matmul_tensor(Model* m, State* s, int tensor, int layer, float* xout, const float* x,
+                          int n, int d) {
+    switch (tensor) {
+        case T_WQ:   matmul(xout, x, m->wq + (long)layer * d * n, n, d); break;
+        case T_WK:   matmul(xout, x, m->wk + (long)layer * d * n, n, d); break;
+        case T_WV:   matmul(xout, x, m->wv + (long)layer * d * n, n, d); break;
+        case T_WCLS: matmul(xout, x, m->wcls, n, d); break;
+        default:
+            matmul_proj(s, xout, x, &m->proj[layer * PROJ_COUNT + tensor - T_WO], n, d);
+            break;
+    }
+}
+
+static inline void layer_matmul(Model* m, State* s, int tensor, int layer, float* xout, const float* x,
+                         int n, int d) {
+    if (s->matmul) s->matmul(m, s, tensor, layer, xout, x, n, d);
+    else matmul_tensor(m, s, tensor, layer, xout, x, n, d);
+}
+
+/* Exact attention of head h over positions 0..pos into its slice of s->xb */
+static inline void attention_head(Model* m, State* s, int layer, int h, int pos) {
+    Config* p = &m->c;
+    int head_size = p->dim / p->n_heads;
+    int kv_dim = (p->dim * p->n_kv_heads) / p->n_heads;
+    int g = h / (p->n_heads / p->n_kv_heads);
+    long loff = (long)layer * p->seq_len * kv_dim;
+    float* q = s->q + h * head_size;
+    float* att = s->att + h * p->seq_len;
+    float* xb = s->xb + h * head_size;
+    for (int t = 0; t <= pos; t++) {
+        float* kt = s->key_cache + loff + t * kv_dim + g * head_size;
+        float score = 0.0f;
+        for (int i = 0; i < head_size; i++) score += q[i] * kt[i];
+        att[t] = score / sqrtf(head_size);
+    }
+    softmax(att, pos + 1);
+    memset(xb, 0, head_size * sizeof(float));
+    for (int t = 0; t <= pos; t++) {
+        float* vt = s->value_cache + loff + t * kv_dim + g * head_size;
+        for (int i = 0; i < head_size; i++) xb[i] += att[t] * vt[i];
+    }
+}
+
+static inline float* forward(Model* m, State* s, int token, int pos) {
+    Config* p = &m->c;
+    float* x = s->x;
+    int dim = p->dim;
+    int kv_dim = (p->dim * p->n_kv_heads) / p->n_heads;
+    int head_size = dim / p->n_heads;
+
+    memcpy(x, m->token_embedding_table + (long)token * dim, dim * sizeof(*x));
+
+    for (int l = 0; l < p->n_layers; l++) {
+        int hidden_dim = layer_ffn(m, l);
+        rmsnorm(s->xb, x, m->rms_att_weight + l * dim, dim);
+
+        long loff = (long)l * p->seq_len * kv_dim;
+        float* k = s->key_cache + loff + pos * kv_dim;
+        float* v = s->value_cache + loff + pos * kv_dim;
+
+        layer_matmul(m, s, T_WQ, l, s->q, s->xb, dim, dim);
+        layer_matmul(m, s, T_WK, l, k, s->xb, dim, kv_dim);
+        layer_matmul(m, s, T_WV, l, v, s->xb, dim, kv_dim);
+
+        for (int i = 0; i < dim; i += 2) {
+            int head_dim = i % head_size;
+            float freq = 1.0f / powf(10000.0f, head_dim / (float)head_size);
+            float val = pos * freq;
+            float fcr = cosf(val);
+            float fci = sinf(val);
+            int rotn = i < kv_dim ? 2 : 1;
+            for (int r = 0; r < rotn; r++) {
+                float* vec = r == 0 ? s->q : k;
+                float v0 = vec[i];
+                float v1 = vec[i + 1];
+                vec[i] = v0 * fcr - v1 * fci;
+                vec[i + 1] = v0 * fci + v1 * fcr;
+            }
+        }
+
+        if (s->attention) {
+            s->attention(m, s, l, pos);
+        } else {
+            for (int h = 0; h < p->n_heads; h++) attention_head(m, s, l, h, pos);
+        }
+
+        layer_matmul(m, s, T_WO, l, s->xb2, s->xb, dim, dim);
+        for (int i = 0; i < dim; i++) x[i] += s->xb2[i];
+
+        rmsnorm(s->xb, x, m->rms_ffn_weight + l * dim, dim);
+        layer_matmul(m, s, T_W1, l, s->hb, s->xb, dim, hidden_dim);
+        layer_matmul(m, s, T_W3, l, s->hb2, s->xb, dim, hidden_dim);
+        for (int i = 0; i < hidden_dim; i++) {
+            float val = s->hb[i];
+            val *= 1.0f / (1.0f + expf(-val));
+            s->hb[i] = val * s->hb2[i];
+        }
+        if (s->ffn) s->ffn(m, s, l, s->hb, hidden_dim);
+        layer_matmul(m, s, T_W2, l, s->xb, s->hb, hidden_dim, dim);
+        for (int i = 0; i < dim; i++) x[i] += s->xb[i];
+    }
+
+    rmsnorm(x, x, m->rms_final_weight, dim);
+    layer_matmul(m, s, T_WCLS, 0, s->logits, x, dim, p->vocab_size);
+    return s->logits;
+}
+
+static inline int argmax(const float* v, int n) {
+    int best = 0;
+    for (int i = 1; i < n; i++) if (v[i] > v[best]) best = i;
+    return best;
+}
+
+/* ============================================
+ * Text and sampled tokens
+ * ============================================ */
+
+typedef struct {
+    char** vocab;
+    float* scores;
+    int vocab_size;
+} Tokenizer;
+
+static inline void load_tokenizer(Tokenizer* t, const char* path, int vocab_size) {
+    FILE* f = fopen(path, "rb");
+    int max_len, len;
+    if (!f || fread(&max_len, sizeof(int), 1, f) != 1) {
+        fprintf(stderr, "cannot read %s\n", path);
+        exit(1);
+    }
+    t->vocab_size = vocab_size;
+    t->vocab = xcalloc(vocab_size, sizeof(char*));
+    t->scores = xcalloc(vocab_size, sizeof(float));
+    for (int i = 0; i < vocab_size; i++) {
+        if (fread(&t->scores[i], sizeof(float), 1, f) != 1 || fread(&len, sizeof(int), 1, f) != 1) {
+            fprintf(stderr, "%s: %d tokens, model has %d\n", path, i, vocab_size);
+            exit(1);
+        }
+        t->vocab[i] = xcalloc(len + 1, 1);
+        if (fread(t->vocab[i], 1, len, f) != (size_t)len) {
+            fprintf(stderr, "%s: short read\n", path);
+            exit(1);
+        }
+    }
+    fclose(f);
+}
+
+static inline int str_lookup(const Tokenizer* t, const char* str) {
+    for (int i = 0; i < t->vocab_size; i++) {
+        if (strcmp(t->vocab[i], str) == 0) return i;
+    }
+    return -1;
+}
+
+/* encode() from the firmware without BOS/EOS; tokens holds strlen(text) + 1 */
+static inline int encode(const Tokenizer* t, const char* text, int* tokens) {
+    char buf[64];
+    int n = 0;
+    size_t str_len = 0;
+    if (text[0] != '\0') {
+        int dummy_prefix = str_lookup(t, " ");
+        if (dummy_prefix != -1) tokens[n++] = dummy_prefix;
+    }
+    for (const char* c = text; *c != '\0'; c++) {
+        if ((*c & 0xC0) != 0x80) str_len = 0;
+        buf[str_len++] = *c;
+        buf[str_len] = '\0';
+        if ((*(c + 1) & 0xC0) == 0x80 && str_len < 4) continue;
+        int id = str_lookup(t, buf);
+        if (id != -1) {
+            tokens[n++] = id;
+        } else {
+            for (size_t i = 0; i < str_len; i++) tokens[n++] = (unsigned char)buf[i] + 3;
+        }
+        str_len = 0;
+    }
+    while (1) {
+        float best_score = -1e10f;
+        int best_id = -1, best_idx = -1;
+        for (int i = 0; i < n - 1; i++) {
+            size_t a = strlen(t->vocab[tokens[i]]), b = strlen(t->vocab[tokens[i + 1]]);
+            if (a + b >= sizeof(buf)) continue;
+            memcpy(buf, t->vocab[tokens[i]], a);
+            memcpy(buf + a, t->vocab[tokens[i + 1]], b + 1);
+            int id = str_lookup(t, buf);
+            if (id != -1 && t->scores[id] > best_score) {
+                best_score = t->scores[id];
+                best_id = id;
+                best_idx = i;
+            }
+        }
+        if (best_idx == -1) break;
+        tokens[best_idx] = best_id;
+        memmove(tokens + best_idx + 1, tokens + best_idx + 2, (n - best_idx - 2) * sizeof(int));
+        n--;
+    }
+    return n;
+}
+
+static inline char* read_text(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* text = xcalloc(size + 1, 1);
+    if (fread(text, 1, size, f) != (size_t)size) {
+        fprintf(stderr, "%s: short read\n", path);
+        exit(1);
+    }
+    fclose(f);
+    return text;
+}
+
+static uint32_t rng_state = 42;
+
+static inline float random_f32(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (rng_state >> 8) / 16777216.0f;
+}
+
+static inline int sample(float* logits, int n) {
+    softmax(logits, n);
+    float r = random_f32(), cdf = 0.0f;
+    for (int i = 0; i < n; i++) {
+        cdf += logits[i];
+        if (r < cdf) return i;
+    }
+    return n - 1;
+}
+
+/* Sequences of seq_len tokens, each starting with BOS (1) */
+typedef struct {
+    int* tokens;
+    int n_seq;
+    int seq_len;
+} Corpus;
+
+/* At least min_seq sequences of the encoded text, up to max_tokens */
+static inline void text_corpus(Corpus* c, const Tokenizer* t, const char* text, int seq_len, int max_tokens,
+                        int min_seq) {
+    int* ids = xcalloc(strlen(text) + 2, sizeof(int));
+    int n = encode(t, text, ids);
+    int body = seq_len - 1;
+    if (n > max_tokens) n = max_tokens;
+    c->seq_len = seq_len;
+    c->n_seq = n / body;
+    if (c->n_seq < min_seq) {
+        fprintf(stderr, "text too short: %d tokens, need %d\n", n, min_seq * body);
+        exit(1);
+    }
+    c->tokens = xcalloc((long)c->n_seq * seq_len, sizeof(int));
+    for (int i = 0; i < c->n_seq; i++) {
+        c->tokens[(long)i * seq_len] = 1;
+        memcpy(c->tokens + (long)i * seq_len + 1, ids + (long)i * body, body * sizeof(int));
+    }
+    free(ids);
+}
+
+/* At least min_seq sequences sampled from the model from BOS, up to max_tokens */
+static inline void sampled_corpus(Corpus* c, Model* m, State* s, int seq_len, int max_tokens, int min_seq) {
+    c->seq_len = seq_len;
+    c->n_seq = max_tokens / seq_len < min_seq ? min_seq : max_tokens / seq_len;
+    c->tokens = xcalloc((long)c->n_seq * seq_len, sizeof(int));
+    for (int i = 0; i < c->n_seq; i++) {
+        int* seq = c->tokens + (long)i * seq_len;
+        seq[0] = 1;
+        for (int pos = 0; pos + 1 < seq_len; pos++) {
+            seq[pos + 1] = sample(forward(m, s, seq[pos], pos), m->c.vocab_size);
+        }
+    }
+}
+
+/* ============================================
+ * Writing model.bin
+ * ============================================ */
+
+static inline uint32_t crc32_update(uint32_t c, const void* data, size_t len) {
+    const uint8_t* p = data;
+    c = ~c;
+    while (len--) {
+        c ^= *p++;
+        for (int k = 0; k < 8; k++) c = (c >> 1) ^ (0xEDB88320u & -(c & 1));
+    }
+    return ~c;
+}
+
+/* CRC32 of everything written with write_crc() since it was last cleared */
+static uint32_t write_crc_value = 0;
+
+static inline void write_crc(FILE* f, const void* data, size_t size) {
+    write_crc_value = crc32_update(write_crc_value, data, size);
+    fwrite(data, 1, size, f);
+}
+
+static inline void write_crc_trailer(FILE* f) {
+    uint32_t trailer[2] = { MODEL_CRC_MAGIC, write_crc_value };
+    fwrite(trailer, sizeof(trailer), 1, f);
+}
+
+/* One projection of every layer, dense or V then U */
+static inline void write_projs(FILE* f, const Model* m, int k) {
+    for (int l = 0; l < m->c.n_layers; l++) {
+        const Proj* pr = &m->proj[l * PROJ_COUNT + k];
+        int d, n;
+        proj_shape(m, l, k, &d, &n);
+        if (pr->rank) {
+            write_crc(f, pr->v, (long)pr->rank * n * sizeof(float));
+            write_crc(f, pr->w, (long)d * pr->rank * sizeof(float));
+        } else {
+            write_crc(f, pr->w, (long)d * n * sizeof(float));
+        }
+    }
+}
+
+#endif /* HOST_MODEL_H */
@@ -0,0 +1,436 @@
+/*
+ * Low-rank factorization of projections (host build)
+ *
+ * Replaces chosen wo/w1/w2/w3 matrices of a llama2.c model.bin by a truncated
+ * SVD, W (d x n) ~= U (d x r) * V (r x n), and writes the factorized
+ * checkpoint: negative n_layers, a rank per layer for wo, w1, w2, w3 after the
+ * Config header (and FFN width table), each factorized layer stored as V then
+ * U, CRC32 trailer (see build_transformer_from_memory()). The firmware applies
+ * them as U (V x) with the rank-r intermediate in BRAM.
+ *
+ * Ranks are chosen against perplexity, not reconstruction error: each matrix
+ * gets the smallest rank (multiple of 4) that still makes it smaller and
+ * keeps the perplexity with only that matrix factorized within --budget
+ * percent of the original; a matrix with no such rank stays dense. Then,
+ * while all of them together are over --total percent, the matrix that costs
+ * the most perplexity per byte saved goes back to dense. --rank r fixes the
+ * rank instead (no budget). Perplexity is measured on tokens sampled from
+ * the original model from BOS (temperature 1, fixed seed), or on --text
+ * encoded with --tokenizer; the report lists rank, bytes saved and
+ * perplexity per matrix.
+ *
+ * Build and run:
+ *   make lowrank
+ *   gcc -O2 -Wall -o tools/lowrank tools/lowrank.c -lm
+ *   tools/lowrank dist/assets/model.bin lowrank.bin [--budget 1.0] [--total 2.0 | --rank r]
+ *       [--tensors wo,w1,w2,w3] [--text file --tokenizer tokenizer.bin] [--tokens n]
+ */
+
+#include "host_model.h"
+
+#define RANK_ALIGN          4           /* int8 rows of U pack 4 per word (quant.h) */
+#define JACOBI_SWEEPS       60
+
+/* ============================================
+ * Evaluation
+ * ============================================ */
+
+static double perplexity(Model* m, State* s, const Corpus* c) {
+    double nll = 0.0;
+    long n = 0;
+    for (int i = 0; i < c->n_seq; i++) {
+        const int* seq = c->tokens + (long)i * c->seq_len;
+        for (int pos = 0; pos + 1 < c->seq_len; pos++) {
+            float* logits = forward(m, s, seq[pos], pos);
+            softmax(logits, m->c.vocab_size);
+            nll -= log(logits[seq[pos + 1]] + 1e-30);
+            n++;
+        }
+    }
+    return exp(nll / n);
+}
+
+/* ============================================
+ * Factorization
+ * ============================================ */
+
+/*
+ * One-sided Jacobi SVD of a (rows x cols, row-major, column-major use):
+ * rotates column pairs of a until they are orthogonal, accumulating the
+ * rotations in v (cols x cols). Afterwards a = U S and a_in = a v^T, with
+ * the singular values s[j] = |a[:, j]| sorted in descending order.
+ */
+static void svd_jacobi(double* a, int rows, int cols, double* v, double* s) {
+    for (int i = 0; i < cols; i++) {
+        for (int j = 0; j < cols; j++) v[i * cols + j] = i == j;
+    }
+    for (int sweep = 0; sweep < JACOBI_SWEEPS; sweep++) {
+        int rotated = 0;
+        for (int p = 0; p < cols - 1; p++) {
+            for (int q = p + 1; q < cols; q++) {
+                double alpha = 0.0, beta = 0.0, gamma = 0.0;
+                for (int i = 0; i < rows; i++) {
+                    double ap = a[(long)i * cols + p], aq = a[(long)i * cols + q];
+                    alpha += ap * ap;
+                    beta += aq * aq;
+                    gamma += ap * aq;
+                }
+                if (fabs(gamma) <= 1e-12 * sqrt(alpha * beta) || gamma == 0.0) continue;
+                rotated = 1;
+                double zeta = (beta - alpha) / (2.0 * gamma);
+                double t = (zeta >= 0.0 ? 1.0 : -1.0) / (fabs(zeta) + sqrt(1.0 + zeta * zeta));
+                double c = 1.0 / sqrt(1.0 + t * t), sn = c * t;
+                for (int i = 0; i < rows; i++) {
+                    double ap = a[(long)i * cols + p], aq = a[(long)i * cols + q];
+                    a[(long)i * cols + p] = c * ap - sn * aq;
+                    a[(long)i * cols + q] = sn * ap + c * aq;
+                }
+                for (int i = 0; i < cols; i++) {
+                    double vp = v[i * cols + p], vq = v[i * cols + q];
+                    v[i * cols + p] = c * vp - sn * vq;
+                    v[i * cols + q] = sn * vp + c * vq;
+                }
+            }
+        }
+        if (!rotated) break;
+    }
+    for (int j = 0; j < cols; j++) {
+        double ss = 0.0;
+        for (int i = 0; i < rows; i++) ss += a[(long)i * cols + j] * a[(long)i * cols + j];
+        s[j] = sqrt(ss);
+    }
+    /* Selection sort of the columns by singular value */
+    for (int j = 0; j < cols; j++) {
+        int best = j;
+        for (int k = j + 1; k < cols; k++) if (s[k] > s[best]) best = k;
+        if (best == j) continue;
+        double tmp = s[j]; s[j] = s[best]; s[best] = tmp;
+        for (int i = 0; i < rows; i++) {
+            tmp = a[(long)i * cols + j];
+            a[(long)i * cols + j] = a[(long)i * cols + best];
+            a[(long)i * cols + best] = tmp;
+        }
+        for (int i = 0; i < cols; i++) {
+            tmp = v[i * cols + j]; v[i * cols + j] = v[i * cols + best]; v[i * cols + best] = tmp;
+        }
+    }
+}
+
+typedef enum { FAC_NONE, FAC_KEPT, FAC_OVER_BUDGET, FAC_DROPPED, FAC_NOT_SMALLER } FactorResult;
+
+typedef struct {
+    int layer, k, d, n;
+    int rank;               /* rank tried last / kept; factors valid when non-zero */
+    double error;           /* relative Frobenius error at rank */
+    float *u, *v;           /* U (d x rank), V (rank x n) */
+    double ppl;             /* with only this projection factorized at rank */
+    FactorResult result;
+    Proj dense;
+    /* SVD (factor_svd): w = a v^T, or its transpose */
+    int transpose, cols;
+    double *a, *sv, *s;
+} Factor;
+
+/* Relative Frobenius error of keeping the first r singular values */
+static double rank_error(const double* s, int count, int r) {
+    double all = 0.0, tail = 0.0;
+    for (int j = 0; j < count; j++) {
+        all += s[j] * s[j];
+        if (j >= r) tail += s[j] * s[j];
+    }
+    return all > 0.0 ? sqrt(tail / all) : 0.0;
+}
+
+/*
+ * SVD of the dense d x n matrix w. Decomposes w itself when n <= d (fewer
+ * columns to rotate), else w^T; either way U gets the d-side vectors and V
+ * the n-side ones, with the singular values folded into one side.
+ */
+static void factor_svd(Factor* f, const float* w) {
+    int d = f->d, n = f->n;
+    f->transpose = n > d;
+    int rows = f->transpose ? n : d, cols = f->transpose ? d : n;
+    f->cols = cols;
+    f->a = xcalloc((long)rows * cols, sizeof(double));
+    f->sv = xcalloc((long)cols * cols, sizeof(double));
+    f->s = xcalloc(cols, sizeof(double));
+    for (int i = 0; i < d; i++) {
+        for (int j = 0; j < n; j++) {
+            double x = w[(long)i * n + j];
+            if (f->transpose) f->a[(long)j * cols + i] = x;
+            else f->a[(long)i * cols + j] = x;
+        }
+    }
+    svd_jacobi(f->a, rows, cols, f->sv, f->s);
+}
+
+/* Largest rank (multiple of RANK_ALIGN) whose factors are smaller than w, 0 if none */
+static int factor_max_rank(const Factor* f) {
+    int r = f->cols < HOST_MAX_RANK ? f->cols : HOST_MAX_RANK;
+    r -= r % RANK_ALIGN;
+    while (r > 0 && (long)r * (f->d + f->n) >= (long)f->d * f->n) r -= RANK_ALIGN;
+    return r;
+}
+
+/* U and V for the first r singular values */
+static void factor_rank(Factor* f, int r) {
+    int d = f->d, n = f->n, cols = f->cols;
+    free(f->u);
+    free(f->v);
+    f->rank = r;
+    f->error = rank_error(f->s, cols, r);
+    f->u = xcalloc((long)d * r, sizeof(float));
+    f->v = xcalloc((long)r * n, sizeof(float));
+    for (int j = 0; j < r; j++) {
+        for (int i = 0; i < d; i++) {
+            f->u[(long)i * r + j] = (float)(f->transpose ? f->sv[(long)i * cols + j] : f->a[(long)i * cols + j]);
+        }
+        for (int i = 0; i < n; i++) {
+            f->v[(long)j * n + i] = (float)(f->transpose ? f->a[(long)i * cols + j] : f->sv[(long)i * cols + j]);
+        }
+    }
+}
+
+static void factor_apply(Model* m, const Factor* f) {
+    Proj* pr = &m->proj[f->layer * PROJ_COUNT + f->k];
+    pr->w = f->u;
+    pr->v = f->v;
+    pr->rank = f->rank;
+}
+
+static void factor_restore(Model* m, const Factor* f) {
+    m->proj[f->layer * PROJ_COUNT + f->k] = f->dense;
+}
+
+/* Perplexity with only this projection factorized at rank r */
+static double factor_try(Factor* f, int r, Model* m, State* s, const Corpus* c) {
+    factor_rank(f, r);
+    factor_apply(m, f);
+    f->ppl = perplexity(m, s, c);
+    factor_restore(m, f);
+    return f->ppl;
+}
+
+static long factor_saved(const Factor* f) {
+    return 4L * ((long)f->d * f->n - (long)f->rank * (f->d + f->n));
+}
+
+static void write_model(const Model* m, const char* path) {
+    const Config* p = &m->c;
+    int L = p->n_layers, dim = p->dim;
+    int head_size = dim / p->n_heads;
+    long kv_dim = (long)p->n_kv_heads * head_size;
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path);
+        exit(1);
+    }
+    Config out = *p;
+    out.hidden_dim = m->pruned ? -p->hidden_dim : p->hidden_dim;
+    out.n_layers = -L;
+    out.vocab_size = m->shared_weights ? p->vocab_size : -p->vocab_size;
+    write_crc_value = 0;
+    write_crc(f, &out, sizeof(out));
+    if (m->pruned) write_crc(f, m->ffn_dim, L * sizeof(int));
+    for (int i = 0; i < L * PROJ_COUNT; i++) write_crc(f, &m->proj[i].rank, sizeof(int));
+
+    write_crc(f, m->token_embedding_table, (long)p->vocab_size * dim * sizeof(float));
+    write_crc(f, m->rms_att_weight, (long)L * dim * sizeof(float));
+    write_crc(f, m->wq, (long)L * dim * dim * sizeof(float));
+    write_crc(f, m->wk, L * dim * kv_dim * sizeof(float));
+    write_crc(f, m->wv, L * dim * kv_dim * sizeof(float));
+    write_projs(f, m, PROJ_WO);
+    write_crc(f, m->rms_ffn_weight, (long)L * dim * sizeof(float));
+    write_projs(f, m, PROJ_W1);
+    write_projs(f, m, PROJ_W2);
+    write_projs(f, m, PROJ_W3);
+    write_crc(f, m->rms_final_weight, dim * sizeof(float));
+    write_crc(f, m->freq_cis, (long)p->seq_len * head_size * sizeof(float));
+    if (!m->shared_weights) write_crc(f, m->wcls, (long)p->vocab_size * dim * sizeof(float));
+
+    write_crc_trailer(f);
+    fclose(f);
+}
+
+/* MACs per token in wo/w1/w2/w3 */
+static long proj_macs(const Model* m) {
+    long macs = 0;
+    for (int l = 0; l < m->c.n_layers; l++) {
+        for (int k = 0; k < PROJ_COUNT; k++) {
+            int d, n;
+            proj_shape(m, l, k, &d, &n);
+            macs += proj_elems(&m->proj[l * PROJ_COUNT + k], d, n);
+        }
+    }
+    return macs;
+}
+
+/* ============================================
+ * Report
+ * ============================================ */
+
+static void usage(const char* prog) {
+    fprintf(stderr, "usage: %s model.bin out.bin [--budget pct] [--total pct | --rank r] "
+            "[--tensors wo,w1,w2,w3] [--text file --tokenizer tokenizer.bin] [--tokens n]\n", prog);
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) usage(argv[0]);
+    const char *text_path = NULL, *tok_path = NULL, *tensors = "wo,w1,w2,w3";
+    double budget = 1.0, total = 2.0;
+    int fixed_rank = 0, max_tokens = 1024;
+    for (int i = 3; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        if (strcmp(argv[i], "--budget") == 0) budget = atof(argv[++i]);
+        else if (strcmp(argv[i], "--total") == 0) total = atof(argv[++i]);
+        else if (strcmp(argv[i], "--rank") == 0) fixed_rank = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tensors") == 0) tensors = argv[++i];
+        else if (strcmp(argv[i], "--text") == 0) text_path = argv[++i];
+        else if (strcmp(argv[i], "--tokenizer") == 0) tok_path = argv[++i];
+        else if (strcmp(argv[i], "--tokens") == 0) max_tokens = atoi(argv[++i]);
+        else usage(argv[0]);
+    }
+    if (text_path && !tok_path) usage(argv[0]);
+
+    Model m;
+    load_model(&m, argv[1]);
+    Config* p = &m.c;
+    int L = p->n_layers;
+    State s;
+    alloc_state(&s, p);
+
+    Corpus corpus;
+    if (text_path) {
+        Tokenizer t;
+        load_tokenizer(&t, tok_path, p->vocab_size);
+        text_corpus(&corpus, &t, read_text(text_path), p->seq_len, max_tokens, 1);
+    } else {
+        sampled_corpus(&corpus, &m, &s, p->seq_len, max_tokens, 1);
+    }
+    double ppl_before = perplexity(&m, &s, &corpus);
+    long macs_before = proj_macs(&m);
+
+    double ppl_budget = ppl_before * (1.0 + budget / 100.0);
+    double ppl_total = ppl_before * (1.0 + total / 100.0);
+
+    /* Each chosen dense projection alone: smallest rank within the budget
+     * (perplexity falls as the rank grows, so binary search the ranks) */
+    Factor* fac = xcalloc(L * PROJ_COUNT, sizeof(Factor));
+    for (int k = 0; k < PROJ_COUNT; k++) {
+        const char* hit = strstr(tensors, proj_names[k]);
+        int chosen = hit && (hit[2] == ',' || hit[2] == '\0');
+        for (int l = 0; l < L && chosen; l++) {
+            Factor* f = &fac[l * PROJ_COUNT + k];
+            f->layer = l;
+            f->k = k;
+            f->dense = m.proj[l * PROJ_COUNT + k];
+            proj_shape(&m, l, k, &f->d, &f->n);
+            if (f->dense.rank) continue;     /* already factorized */
+            factor_svd(f, f->dense.w);
+            int max_rank = factor_max_rank(f);
+            if (fixed_rank) {
+                int r = fixed_rank < max_rank ? fixed_rank : 0;
+                if (r) factor_try(f, r, &m, &s, &corpus);
+                f->result = r ? FAC_KEPT : FAC_NOT_SMALLER;
+                continue;
+            }
+            if (!max_rank) {
+                f->result = FAC_NOT_SMALLER;
+                continue;
+            }
+            int lo = 1, hi = max_rank / RANK_ALIGN, best = 0;
+            double best_ppl = 0.0;
+            while (lo <= hi) {
+                int mid = (lo + hi) / 2;
+                double ppl = factor_try(f, mid * RANK_ALIGN, &m, &s, &corpus);
+                if (ppl <= ppl_budget) {
+                    best = mid;
+                    best_ppl = ppl;
+                    hi = mid - 1;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            if (best) {
+                factor_rank(f, best * RANK_ALIGN);
+                f->ppl = best_ppl;
+                f->result = FAC_KEPT;
+            } else {
+                if (f->rank != max_rank) factor_try(f, max_rank, &m, &s, &corpus);
+                f->result = FAC_OVER_BUDGET;
+            }
+        }
+    }
+
+    /* All kept matrices together: drop the worst perplexity per byte saved
+     * until within the total budget */
+    for (int i = 0; i < L * PROJ_COUNT; i++) {
+        if (fac[i].result == FAC_KEPT) factor_apply(&m, &fac[i]);
+    }
+    while (!fixed_rank) {
+        Factor* worst = NULL;
+        double worst_cost = 0.0;
+        for (int i = 0; i < L * PROJ_COUNT; i++) {
+            Factor* f = &fac[i];
+            if (f->result != FAC_KEPT) continue;
+            double cost = (f->ppl - ppl_before) / factor_saved(f);
+            if (!worst || cost > worst_cost) {
+                worst = f;
+                worst_cost = cost;
+            }
+        }
+        if (!worst || perplexity(&m, &s, &corpus) <= ppl_total) break;
+        factor_restore(&m, worst);
+        worst->result = FAC_DROPPED;
+    }
+    write_model(&m, argv[2]);
+
+    /* Reload the written file: checks the layout as well as the accuracy */
+    Model fm;
+    load_model(&fm, argv[2]);
+    State fs;
+    alloc_state(&fs, &fm.c);
+    double ppl_after = perplexity(&fm, &fs, &corpus);
+
+    printf("# Low-rank factorization\n\n");
+    printf("`%s` -> `%s`: dim=%d layers=%d, perplexity over %d sequences of %d tokens %s.\n\n",
+           argv[1], argv[2], p->dim, L, corpus.n_seq, p->seq_len,
+           text_path ? "from the text file" : "sampled from the original model (temperature 1, seed 42)");
+    if (fixed_rank) {
+        printf("Rank %d for %s; matrices whose factors would not be smaller stay dense. ", fixed_rank, tensors);
+    } else {
+        printf("For %s, the smallest rank (multiple of %d) that makes the matrix smaller and keeps the "
+               "perplexity with only that matrix factorized within +%.1f%%; matrices with no such rank stay "
+               "dense. Then, while all of them together are over +%.1f%%, the matrix with the most "
+               "perplexity per byte saved goes back to dense. ", tensors, RANK_ALIGN, budget, total);
+    }
+    printf("Perplexity per row is with only that matrix factorized, at the rank shown (for dense "
+           "rows, the largest rank that would still save bytes).\n\n");
+
+    static const char* results[] = { "", "factorized", "dense: over budget", "dense: over total",
+                                     "dense: not smaller" };
+    printf("| Layer | Tensor | Shape | Rank | Rel. error | Saved bytes | Perplexity | Change | Result |\n");
+    printf("|---:|---|---|---:|---:|---:|---:|---:|---|\n");
+    for (int i = 0; i < L * PROJ_COUNT; i++) {
+        Factor* f = &fac[i];
+        if (!f->d || f->result == FAC_NONE) continue;
+        if (f->result == FAC_NOT_SMALLER) {
+            printf("| %d | %s | %dx%d | - | - | - | - | - | %s |\n", f->layer, proj_names[f->k],
+                   f->d, f->n, results[f->result]);
+            continue;
+        }
+        printf("| %d | %s | %dx%d | %d | %.3f | %ld | %.3f | %+.1f%% | %s |\n", f->layer,
+               proj_names[f->k], f->d, f->n, f->rank, f->error,
+               f->result == FAC_KEPT ? factor_saved(f) : 0L, f->ppl,
+               100.0 * (f->ppl - ppl_before) / ppl_before, results[f->result]);
+    }
+    printf("\n| | Before | After | Change |\n|---|---:|---:|---:|\n");
+    printf("| wo/FFN MACs per token | %ld | %ld | %.1f%% |\n", macs_before, proj_macs(&fm),
+           100.0 * (proj_macs(&fm) - macs_before) / macs_before);
+    printf("| Model bytes | %ld | %ld | %.1f%% |\n", file_size(argv[1]), file_size(argv[2]),
+           100.0 * (file_size(argv[2]) - file_size(argv[1])) / file_size(argv[1]));
+    printf("| Perplexity | %.3f | %.3f | %+.1f%% |\n", ppl_before, ppl_after,
+           100.0 * (ppl_after - ppl_before) / ppl_before);
+    return 0;
+}
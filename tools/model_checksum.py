@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""
+Checksum trailer for model.bin and tokenizer.bin.
+
+The firmware computes a CRC32 of each data slot in hardware while the bridge
+writes it to SDRAM (src/fpga/core/dataslot_crc.v) and compares the model and
+tokenizer slots against a trailer stored after the data:
+  uint32 magic    'CR32' (0x32335243)
+  uint32 crc32    zlib CRC32 of every byte before the trailer
+The firmware finds the model trailer from the Config header, so it must
+directly follow the last tensor; the tokenizer trailer ends the file. Files
+without it still load (nothing to compare).
+
+Usage:
+    python3 tools/model_checksum.py add dist/assets/model.bin     # add or refresh
+    python3 tools/model_checksum.py verify dist/assets/model.bin  # exit 1 on mismatch
+    python3 tools/model_checksum.py add --tokenizer dist/assets/tokenizer.bin
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import gen_model
+
+TRAILER_MAGIC = gen_model.CHECKSUM_MAGIC
+TRAILER_BYTES = gen_model.CHECKSUM_BYTES
+
+CHUNK = 1 << 20
+
+
+def weights_end(path):
+    """Byte offset of the end of the last tensor, from the Config header."""
+    c, shared = gen_model.read_config(path)
+    return gen_model.model_bytes(c, shared) - TRAILER_BYTES
+
+
+def tokens_end(path):
+    """Byte offset of the end of the last token record."""
+    with open(path, 'rb') as f:
+        return gen_model.tokenizer_end(f.read())
+
+
+def file_crc(path, length):
+    crc = 0
+    with open(path, 'rb') as f:
+        while length:
+            data = f.read(min(length, CHUNK))
+            if not data:
+                raise ValueError('%s: truncated' % path)
+            crc = zlib.crc32(data, crc)
+            length -= len(data)
+    return crc & 0xFFFFFFFF
+
+
+def read_trailer(path, end):
+    """(magic, crc) after the weights, or None."""
+    if os.path.getsize(path) < end + TRAILER_BYTES:
+        return None
+    with open(path, 'rb') as f:
+        f.seek(end)
+        return struct.unpack('<2I', f.read(TRAILER_BYTES))
+
+
+def add(path, data_end=weights_end):
+    end = data_end(path)
+    size = os.path.getsize(path)
+    if size < end:
+        raise ValueError('%s: %d bytes, Config needs %d' % (path, size, end))
+    crc = file_crc(path, end)
+    with open(path, 'r+b') as f:
+        f.seek(end)
+        f.write(struct.pack('<2I', TRAILER_MAGIC, crc))
+        f.truncate()
+    return crc
+
+
+def verify(path, data_end=weights_end):
+    end = data_end(path)
+    trailer = read_trailer(path, end)
+    if trailer is None or trailer[0] != TRAILER_MAGIC:
+        return None, file_crc(path, end)
+    return trailer[1], file_crc(path, end)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='CRC32 trailer for model.bin and tokenizer.bin')
+    parser.add_argument('command', choices=['add', 'verify'])
+    parser.add_argument('--tokenizer', action='store_true', help='the files are tokenizer.bin images')
+    parser.add_argument('model', nargs='+')
+    args = parser.parse_args()
+
+    data_end = tokens_end if args.tokenizer else weights_end
+    failed = False
+    for path in args.model:
+        try:
+            if args.command == 'add':
+                print('%s: crc32 %08X' % (path, add(path, data_end)))
+                continue
+            stored, actual = verify(path, data_end)
+        except (OSError, ValueError, struct.error) as e:
+            print('%s: %s' % (path, e), file=sys.stderr)
+            failed = True
+            continue
+        if stored is None:
+            print('%s: no checksum trailer (crc32 %08X)' % (path, actual))
+        elif stored != actual:
+            print('%s: MISMATCH stored %08X, actual %08X' % (path, stored, actual))
+            failed = True
+        else:
+            print('%s: OK %08X' % (path, actual))
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""
+Model shape sweep: tokens/min and memory placement vs. model size.
+
+For every shape in tools/model_shapes.json:
+  1. generate a random-weight model.bin/tokenizer.bin (tools/gen_model.py)
+  2. run the RUN_BENCH firmware on it in the Verilator harness (src/sim,
+     slots preloaded) and collect forward() cycles/token
+  3. take the placement (SDRAM arena, KV cache, key shadow, int8 weights)
+     from the firmware's "Placement:" line, or the reason it does not fit
+     from its "ERROR:" line
+and print a markdown table; --out also writes it with an SVG bar chart.
+
+Usage:
+    ./tools/model_sweep.py                          # all shapes
+    ./tools/model_sweep.py --only 260K,15M          # subset
+    ./tools/model_sweep.py --placement-only         # stop after the Placement line
+    ./tools/model_sweep.py --out docs/model-sweep.md
+
+Placement is whatever the firmware does, so there is no copy of its layout
+here; only the model slot size is checked up front, since the harness
+cannot preload a model larger than the slot.
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import shutil
+import sys
+
+import gen_model
+from cpu_matrix import CPU_MHZ, ROOT, SIM_DIR, firmware_define, parse_bench, run
+
+# Model slot: from the model's SDRAM address up to the tokenizer slot
+FIRMWARE = 'src/firmware/llama_embedded.c'
+MODEL_SLOT_BYTES = firmware_define('TOKENIZER_SDRAM_ADDR', FIRMWARE) - firmware_define('MODEL_SDRAM_ADDR', FIRMWARE)
+
+MB = 1024.0 * 1024.0
+
+
+def load_shapes(path):
+    with open(path) as f:
+        shapes = json.load(f)['shapes']
+    for s in shapes:
+        c = dict(zip(gen_model.CONFIG_FIELDS, gen_model.PRESETS[s['preset']])) if 'preset' in s else {}
+        c.update(s.get('config', {}))
+        c.setdefault('kv_heads', c['heads'])
+        s['cfg'] = c
+    return shapes
+
+
+# ============================================
+# Simulation
+# ============================================
+
+def parse_placement(text):
+    """The firmware's Placement line as a dict, or fits=False with its ERROR line."""
+    m = re.search(r'^ERROR: *(.*)$', text, re.M)
+    if m:
+        return {'fits': False, 'reason': m.group(1).strip()}
+    m = re.search(r'^Placement: (.*)$', text, re.M)
+    if not m:
+        return {}
+    p = dict(re.findall(r'(\w+)=(\w+)', m.group(1)))
+    p['fits'] = True
+    p['arena_mb'] = int(p.pop('arena').rstrip('KB')) / 1024.0
+    return p
+
+
+def simulate(shape, assets, build, fw_defines, timeout):
+    """(bench results, placement) from one run of the RUN_BENCH firmware."""
+    defines = ['-DRUN_BENCH=1', '-DSIM_CONSOLE'] + fw_defines
+    cmd = ['make', '-C', SIM_DIR, 'run',
+           'ASSETS=' + assets,
+           'BUILD=' + build,
+           'FW_DEFINES=' + ' '.join(defines),
+           'SIM_ARGS=--max-cycles %d' % timeout]
+    log = os.path.join(SIM_DIR, build, shape['name'] + '.log')
+    os.makedirs(os.path.dirname(log), exist_ok=True)
+    run(cmd, log=log)
+    bench_log = os.path.join(SIM_DIR, build, shape['name'] + '.bench.log')
+    src = os.path.join(SIM_DIR, build, 'bench.log')
+    if not os.path.exists(src):
+        return {}, {}
+    shutil.move(src, bench_log)
+    with open(bench_log, errors='replace') as f:
+        text = f.read()
+    return parse_bench(bench_log), parse_placement(text)
+
+
+# ============================================
+# Report
+# ============================================
+
+def fmt(v, spec='{:,}'):
+    return '-' if v is None else spec.format(v)
+
+
+def tok_per_min(bench):
+    cyc = bench.get('fwd_avg_cyc')
+    return int(CPU_MHZ * 1e6 * 60 / cyc) if cyc else None
+
+
+def report(rows):
+    out = []
+    out.append('| Shape | dim/hidden/layers/heads/kv/vocab/seq | Model MB | Arena MB | KV cache | Key shadow | '
+               'Matmul | fwd cyc/tok | tok/min @133MHz | Notes |')
+    out.append('|---|---|---:|---:|---|---|---|---:|---:|---|')
+    for s, p, bench in rows:
+        c = s['cfg']
+        shape = '/'.join(str(c[f]) for f in gen_model.CONFIG_FIELDS)
+        if not p:
+            notes = 'no Placement line from the firmware'
+        elif not p['fits']:
+            notes = p['reason']
+        else:
+            notes = s.get('desc', '')
+        out.append('| %s | %s | %.2f | %s | %s | %s | %s | %s | %s | %s |' % (
+            s['name'], shape, s['model_mb'], fmt(p.get('arena_mb'), '{:.2f}'),
+            p.get('kv', '-'), p.get('key_shadow', '-'), p.get('matmul', '-'),
+            fmt(bench.get('fwd_avg_cyc')), fmt(tok_per_min(bench)), notes))
+    out.append('')
+    out.append('Placement as the firmware reports it. Arena = run state, SDRAM KV cache, key shadow '
+               'and int8 weights after the model in SDRAM.')
+    return '\n'.join(out)
+
+
+def svg_chart(rows):
+    """Bar chart of tokens/min (log scale), coloured by KV cache placement."""
+    bars = [(s['name'], tok_per_min(b), p.get('kv'), s['model_mb'])
+            for s, p, b in rows if p.get('fits') and tok_per_min(b)]
+    if not bars:
+        return None
+    w, h, left, bottom, top = 80 * len(bars) + 100, 320, 70, 60, 30
+    ymax = max(t for _, t, _, _ in bars)
+    decades = max(1, math.ceil(math.log10(ymax)))
+    y = lambda v: top + (h - top - bottom) * (1 - math.log10(max(v, 1)) / decades)
+    colors = {'PSRAM': '#4c72b0', 'SDRAM': '#dd8452'}
+    out = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" font-family="sans-serif" font-size="11">' % (w, h)]
+    for d in range(decades + 1):
+        out.append('<line x1="%d" x2="%d" y1="%.1f" y2="%.1f" stroke="#ddd"/>' % (left, w - 20, y(10 ** d), y(10 ** d)))
+        out.append('<text x="%d" y="%.1f" text-anchor="end">%s</text>' % (left - 5, y(10 ** d) + 4, '{:,}'.format(10 ** d)))
+    for i, (name, tpm, kv, mb) in enumerate(bars):
+        x = left + 20 + 80 * i
+        out.append('<rect x="%d" y="%.1f" width="50" height="%.1f" fill="%s"/>' % (
+            x, y(tpm), h - bottom - y(tpm), colors.get(kv, '#888')))
+        out.append('<text x="%d" y="%.1f" text-anchor="middle">%s</text>' % (x + 25, y(tpm) - 4, '{:,}'.format(tpm)))
+        out.append('<text x="%d" y="%d" text-anchor="middle">%s</text>' % (x + 25, h - bottom + 15, name))
+        out.append('<text x="%d" y="%d" text-anchor="middle">%.1f MB</text>' % (x + 25, h - bottom + 30, mb))
+    out.append('<text x="%d" y="%d">tokens/min @%d MHz (log); KV cache: ' % (left, 18, CPU_MHZ) +
+               '<tspan fill="%s">PSRAM</tspan> / <tspan fill="%s">SDRAM</tspan></text>' % (colors['PSRAM'], colors['SDRAM']))
+    out.append('</svg>')
+    return '\n'.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='model shape sweep')
+    parser.add_argument('--shapes', default=os.path.join(ROOT, 'tools', 'model_shapes.json'))
+    parser.add_argument('--only', help='comma-separated shape names')
+    parser.add_argument('--placement-only', action='store_true', help='stop each run after the Placement line')
+    parser.add_argument('--tokens', type=int, default=4, help='forward() calls timed per shape (BENCH_TOKENS)')
+    parser.add_argument('--fw-defines', default='', help='extra firmware defines, e.g. -DQUANT_MATMUL=1')
+    parser.add_argument('--max-cycles', type=int, default=4000000000)
+    parser.add_argument('--out', help='also write the table (and an .svg chart) to this file')
+    args = parser.parse_args()
+
+    shapes = load_shapes(args.shapes)
+    if args.only:
+        wanted = set(args.only.split(','))
+        shapes = [s for s in shapes if s['name'] in wanted]
+
+    build = os.path.join('build', 'sweep')
+    # Only fwd_avg_cyc is reported: skip the long decode to the bench positions
+    fw_defines = ['-DBENCH_TOKENS=%d' % args.tokens, '-DBENCH_MAX_POS=0'] + args.fw_defines.split()
+    if args.placement_only:
+        fw_defines.append('-DBENCH_PLACEMENT_ONLY')
+    rows = []
+    for s in shapes:
+        model = gen_model.model_bytes(s['cfg'])
+        s['model_mb'] = model / MB
+        p, bench = {}, {}
+        if model > MODEL_SLOT_BYTES:
+            p = {'fits': False, 'reason': 'model > %.0f MB slot' % (MODEL_SLOT_BYTES / MB)}
+        else:
+            assets = os.path.join(SIM_DIR, build, s['name'])
+            cmd = [sys.executable, os.path.join(ROOT, 'tools', 'gen_model.py'), '--out', assets]
+            for field in gen_model.CONFIG_FIELDS:
+                cmd += ['--' + field.replace('_', '-'), str(s['cfg'][field])]
+            if run(cmd):
+                bench, p = simulate(s, assets, build, fw_defines, args.max_cycles)
+            if not p:
+                print('WARNING: %s: no placement from the firmware' % s['name'], file=sys.stderr)
+        rows.append((s, p, bench))
+
+    table = report(rows)
+    print(table)
+    if args.out:
+        svg = svg_chart(rows)
+        with open(args.out, 'w') as f:
+            f.write('# Model shape sweep\n\n')
+            f.write('Generated by `tools/model_sweep.py` (random weights from `tools/gen_model.py`).\n\n')
+            f.write(table + '\n')
+            if svg:
+                svg_path = os.path.splitext(args.out)[0] + '.svg'
+                with open(svg_path, 'w') as g:
+                    g.write(svg + '\n')
+                f.write('\n![tokens/min](%s)\n' % os.path.basename(svg_path))
+
+
+if __name__ == '__main__':
+    main()
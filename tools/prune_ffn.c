@@ -0,0 +1,330 @@
+/*
+ * FFN neuron pruning (host build)
+ *
+ * Runs the firmware's fp32 forward() over calibration tokens and scores every
+ * FFN hidden neuron by mean |silu(w1 x) * (w3 x)| times the L2 norm of its w2
+ * column, i.e. its average contribution to the residual stream. The lowest
+ * scoring neurons are dropped, ranked over all layers relative to each layer's
+ * mean (so layers with a flatter importance profile lose fewer), but no layer
+ * below --floor of its width. The result is written as a model.bin with
+ * per-layer FFN widths: negative hidden_dim, n_layers int32 widths after the
+ * Config header, then the usual tensors and CRC32 trailer (see
+ * build_transformer_from_memory()).
+ *
+ * How much to keep is either fixed (--keep, --widths) or, by default, the
+ * smallest fraction (in 1% steps) whose perplexity on the calibration
+ * sequences stays within --budget percent of the original.
+ *
+ * Calibration tokens come from --text, encoded with --tokenizer the way the
+ * firmware's encode() does, or by default from sampling the model itself
+ * from BOS (temperature 1, fixed seed). Sequences alternate between the
+ * calibration set and a held-out set used only for perplexity.
+ *
+ * Prints a markdown report: widths, FFN MACs per token, model bytes and
+ * held-out perplexity before and after.
+ *
+ * Build and run:
+ *   make ffn-prune
+ *   gcc -O2 -Wall -o tools/prune_ffn tools/prune_ffn.c -lm
+ *   tools/prune_ffn dist/assets/model.bin pruned.bin [--budget 2.0 | --keep f | --widths a,b,...]
+ *       [--floor 0.9] [--text calib.txt --tokenizer tokenizer.bin] [--tokens n]
+ */
+
+#include "host_model.h"
+
+#define MIN_WIDTH           8           /* narrowest FFN layer kept */
+#define WIDTH_ALIGN         4           /* int8 rows pack 4 per word (quant.h) */
+
+static long ffn_macs(const Model* m) {
+    return 3L * m->ffn_off[m->c.n_layers] * m->c.dim;
+}
+
+/* ============================================
+ * Calibration
+ * ============================================ */
+
+/* ffn hook: accumulates |silu(w1 x) * (w3 x)| per neuron into State.user
+ * (ffn_off[L] doubles) */
+static void collect_act(Model* m, State* s, int l, const float* hb, int hidden_dim) {
+    double* act = (double*)s->user + m->ffn_off[l];
+    for (int i = 0; i < hidden_dim; i++) act[i] += fabsf(hb[i]);
+}
+
+/* Perplexity over the odd (held-out) sequences, or the even (calibration)
+ * ones with calib; act over the calibration ones if given */
+static double run_corpus(Model* m, State* s, const Corpus* c, double* act, long* n_act, int calib) {
+    double nll = 0.0;
+    long n = 0;
+    s->ffn = act ? collect_act : NULL;
+    s->user = act;
+    for (int i = act || calib ? 0 : 1; i < c->n_seq; i += 2) {
+        const int* seq = c->tokens + (long)i * c->seq_len;
+        for (int pos = 0; pos + 1 < c->seq_len; pos++) {
+            float* logits = forward(m, s, seq[pos], pos);
+            if (act) continue;
+            softmax(logits, m->c.vocab_size);
+            nll -= log(logits[seq[pos + 1]] + 1e-30);
+            n++;
+        }
+        if (act) *n_act += c->seq_len - 1;
+    }
+    return act ? 0.0 : exp(nll / n);
+}
+
+/* ============================================
+ * Pruning
+ * ============================================ */
+
+typedef struct {
+    float score;
+    int layer;
+    int index;
+} Neuron;
+
+static int by_score_desc(const void* a, const void* b) {
+    float sa = ((const Neuron*)a)->score, sb = ((const Neuron*)b)->score;
+    return sa < sb ? 1 : sa > sb ? -1 : 0;
+}
+
+static int by_index(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+/* keep[l] gets the indices of the widths[l] best neurons of layer l, in order */
+static void select_neurons(const Model* m, const Neuron* ranked, const int* widths, int** keep) {
+    int L = m->c.n_layers;
+    int* n = xcalloc(L, sizeof(int));
+    for (long i = 0; i < m->ffn_off[L]; i++) {
+        int l = ranked[i].layer;
+        if (n[l] < widths[l]) keep[l][n[l]++] = ranked[i].index;
+    }
+    for (int l = 0; l < L; l++) qsort(keep[l], widths[l], sizeof(int), by_index);
+    free(n);
+}
+
+/* Widths from a global keep fraction, at least min_keep of each layer and
+ * MIN_WIDTH, multiples of WIDTH_ALIGN */
+static void widths_from_keep(const Model* m, const Neuron* ranked, double keep, double min_keep, int* widths) {
+    int L = m->c.n_layers;
+    long total = m->ffn_off[L];
+    long kept = (long)(keep * total + 0.5);
+    memset(widths, 0, L * sizeof(int));
+    for (long i = 0; i < kept; i++) widths[ranked[i].layer]++;
+    for (int l = 0; l < L; l++) {
+        int min_w = (int)ceil(min_keep * m->ffn_dim[l]);
+        int w = widths[l] > min_w ? widths[l] : min_w;
+        w = (w + WIDTH_ALIGN - 1) / WIDTH_ALIGN * WIDTH_ALIGN;
+        if (w < MIN_WIDTH) w = MIN_WIDTH;
+        widths[l] = w < m->ffn_dim[l] ? w : m->ffn_dim[l];
+    }
+}
+
+static void write_pruned(const Model* m, int** keep, const int* widths, const char* path) {
+    const Config* p = &m->c;
+    int L = p->n_layers, dim = p->dim;
+    int head_size = dim / p->n_heads;
+    long kv_dim = (long)p->n_kv_heads * head_size;
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path);
+        exit(1);
+    }
+    int hidden = 0;
+    for (int l = 0; l < L; l++) if (widths[l] > hidden) hidden = widths[l];
+    Config out = *p;
+    out.hidden_dim = -hidden;
+    out.vocab_size = m->shared_weights ? p->vocab_size : -p->vocab_size;
+    write_crc_value = 0;
+    write_crc(f, &out, sizeof(out));
+    write_crc(f, widths, L * sizeof(int));
+
+    write_crc(f, m->token_embedding_table, (long)p->vocab_size * dim * sizeof(float));
+    write_crc(f, m->rms_att_weight, (long)L * dim * sizeof(float));
+    write_crc(f, m->wq, (long)L * dim * dim * sizeof(float));
+    write_crc(f, m->wk, L * dim * kv_dim * sizeof(float));
+    write_crc(f, m->wv, L * dim * kv_dim * sizeof(float));
+    write_projs(f, m, PROJ_WO);
+    write_crc(f, m->rms_ffn_weight, (long)L * dim * sizeof(float));
+    /* w1/w3: kept rows of each width x dim layer; w2: kept columns of each dim x width layer */
+    for (int k = PROJ_W1; k <= PROJ_W3; k++) {
+        for (int l = 0; l < L; l++) {
+            const float* wl = m->proj[l * PROJ_COUNT + k].w;
+            if (k != PROJ_W2) {
+                for (int i = 0; i < widths[l]; i++) {
+                    write_crc(f, wl + (long)keep[l][i] * dim, dim * sizeof(float));
+                }
+                continue;
+            }
+            for (int d = 0; d < dim; d++) {
+                for (int i = 0; i < widths[l]; i++) {
+                    write_crc(f, wl + (long)d * m->ffn_dim[l] + keep[l][i], sizeof(float));
+                }
+            }
+        }
+    }
+    write_crc(f, m->rms_final_weight, dim * sizeof(float));
+    write_crc(f, m->freq_cis, (long)p->seq_len * head_size * sizeof(float));
+    if (!m->shared_weights) write_crc(f, m->wcls, (long)p->vocab_size * dim * sizeof(float));
+
+    write_crc_trailer(f);
+    fclose(f);
+}
+
+/* ============================================
+ * Report
+ * ============================================ */
+
+static void usage(const char* prog) {
+    fprintf(stderr, "usage: %s model.bin out.bin [--budget pct | --keep f | --widths a,b,...] "
+            "[--floor f] [--text file --tokenizer tokenizer.bin] [--tokens n]\n", prog);
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) usage(argv[0]);
+    const char *text_path = NULL, *tok_path = NULL, *widths_arg = NULL;
+    double keep = 0.0, min_keep = 0.9, budget = 2.0;
+    int max_tokens = 2048;
+    for (int i = 3; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        if (strcmp(argv[i], "--keep") == 0) keep = atof(argv[++i]);
+        else if (strcmp(argv[i], "--budget") == 0) budget = atof(argv[++i]);
+        else if (strcmp(argv[i], "--floor") == 0) min_keep = atof(argv[++i]);
+        else if (strcmp(argv[i], "--widths") == 0) widths_arg = argv[++i];
+        else if (strcmp(argv[i], "--text") == 0) text_path = argv[++i];
+        else if (strcmp(argv[i], "--tokenizer") == 0) tok_path = argv[++i];
+        else if (strcmp(argv[i], "--tokens") == 0) max_tokens = atoi(argv[++i]);
+        else usage(argv[0]);
+    }
+    if (text_path && !tok_path) usage(argv[0]);
+
+    Model m;
+    load_model(&m, argv[1]);
+    if (m.factorized) {
+        fprintf(stderr, "%s: factorized model, prune before tools/lowrank\n", argv[1]);
+        return 1;
+    }
+    Config* p = &m.c;
+    int L = p->n_layers, dim = p->dim;
+    State s;
+    alloc_state(&s, p);
+
+    Corpus corpus;
+    if (text_path) {
+        Tokenizer t;
+        load_tokenizer(&t, tok_path, p->vocab_size);
+        text_corpus(&corpus, &t, read_text(text_path), p->seq_len, max_tokens, 2);
+    } else {
+        sampled_corpus(&corpus, &m, &s, p->seq_len, max_tokens, 2);
+    }
+
+    /* Importance: mean |activation| on the calibration half times w2 column norm,
+     * relative to the layer mean so the global ranking does not empty the layers
+     * whose activations are small overall (the first ones, after the embedding) */
+    long total = m.ffn_off[L];
+    double* act = xcalloc(total, sizeof(double));
+    long n_act = 0;
+    run_corpus(&m, &s, &corpus, act, &n_act, 1);
+    double ppl_before = run_corpus(&m, &s, &corpus, NULL, NULL, 0);
+    Neuron* ranked = xcalloc(total, sizeof(Neuron));
+    for (int l = 0; l < L; l++) {
+        int h = m.ffn_dim[l];
+        const float* w2 = m.proj[l * PROJ_COUNT + PROJ_W2].w;
+        Neuron* layer = ranked + m.ffn_off[l];
+        double sum = 0.0;
+        for (int i = 0; i < h; i++) {
+            double norm = 0.0;
+            for (int d = 0; d < dim; d++) norm += (double)w2[(long)d * h + i] * w2[(long)d * h + i];
+            layer[i].score = (float)(act[m.ffn_off[l] + i] / n_act * sqrt(norm));
+            layer[i].layer = l;
+            layer[i].index = i;
+            sum += layer[i].score;
+        }
+        for (int i = 0; i < h; i++) {
+            layer[i].score = (float)(layer[i].score * h / (sum + 1e-30));
+        }
+    }
+    qsort(ranked, total, sizeof(Neuron), by_score_desc);
+
+    int* widths = xcalloc(L, sizeof(int));
+    if (widths_arg) {
+        const char* c = widths_arg;
+        for (int l = 0; l < L; l++) {
+            widths[l] = atoi(c);
+            if (widths[l] < 1 || widths[l] > m.ffn_dim[l]) {
+                fprintf(stderr, "--widths: layer %d width must be 1..%d\n", l, m.ffn_dim[l]);
+                return 1;
+            }
+            c = strchr(c, ',');
+            if (!c && l + 1 < L) {
+                fprintf(stderr, "--widths needs %d values\n", L);
+                return 1;
+            }
+            c++;
+        }
+    }
+    int** kept = xcalloc(L, sizeof(int*));
+    for (int l = 0; l < L; l++) kept[l] = xcalloc(m.ffn_dim[l], sizeof(int));
+    int budget_search = !widths_arg && keep <= 0.0;
+    if (budget_search) {
+        /* Smallest keep percentage within the budget on the calibration
+         * sequences; perplexity rises as the model shrinks, so binary search */
+        double calib_before = run_corpus(&m, &s, &corpus, NULL, NULL, 1);
+        int lo = 1, hi = 100;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            widths_from_keep(&m, ranked, mid / 100.0, min_keep, widths);
+            select_neurons(&m, ranked, widths, kept);
+            write_pruned(&m, kept, widths, argv[2]);
+            Model tm;
+            load_model(&tm, argv[2]);
+            State ts;
+            alloc_state(&ts, &tm.c);
+            if (run_corpus(&tm, &ts, &corpus, NULL, NULL, 1) <= calib_before * (1.0 + budget / 100.0)) hi = mid;
+            else lo = mid + 1;
+        }
+        keep = lo / 100.0;
+    }
+    if (!widths_arg) widths_from_keep(&m, ranked, keep, min_keep, widths);
+    select_neurons(&m, ranked, widths, kept);
+    write_pruned(&m, kept, widths, argv[2]);
+
+    /* Reload the written file: checks the layout as well as the accuracy */
+    Model pm;
+    load_model(&pm, argv[2]);
+    State ps;
+    alloc_state(&ps, &pm.c);
+    double ppl_after = run_corpus(&pm, &ps, &corpus, NULL, NULL, 0);
+
+    printf("# FFN pruning\n\n");
+    printf("`%s` -> `%s`: dim=%d layers=%d, %d calibration and %d held-out sequences of %d tokens %s.\n\n",
+           argv[1], argv[2], dim, L, (corpus.n_seq + 1) / 2, corpus.n_seq / 2, p->seq_len,
+           text_path ? "from the text file" : "sampled from the model (temperature 1, seed 42)");
+    printf("Neuron importance is mean |silu(w1 x) * (w3 x)| over the calibration tokens times the "
+           "L2 norm of its w2 column, divided by its layer's mean and ranked over all layers. ");
+    if (widths_arg) {
+        printf("Widths given with `--widths`.\n\n");
+    } else {
+        if (budget_search) {
+            printf("Smallest share of neurons (1%% steps) whose perplexity on the calibration sequences "
+                   "stays within +%.1f%%: k", budget);
+        } else {
+            printf("K");
+        }
+        printf("ept the top %.0f%% of neurons, at least %.0f%% of each layer and %d per layer, rounded up "
+               "to a multiple of %d.\n\n", keep * 100.0, min_keep * 100.0, MIN_WIDTH, WIDTH_ALIGN);
+    }
+
+    printf("| Layer | Width before | Width after | Kept |\n|---:|---:|---:|---:|\n");
+    for (int l = 0; l < L; l++) {
+        printf("| %d | %d | %d | %.0f%% |\n", l, m.ffn_dim[l], widths[l], 100.0 * widths[l] / m.ffn_dim[l]);
+    }
+    printf("\n| | Before | After | Change |\n|---|---:|---:|---:|\n");
+    printf("| FFN MACs per token | %ld | %ld | %.1f%% |\n", ffn_macs(&m), ffn_macs(&pm),
+           100.0 * (ffn_macs(&pm) - ffn_macs(&m)) / ffn_macs(&m));
+    printf("| Model bytes | %ld | %ld | %.1f%% |\n", file_size(argv[1]), file_size(argv[2]),
+           100.0 * (file_size(argv[2]) - file_size(argv[1])) / file_size(argv[1]));
+    printf("| Held-out perplexity | %.3f | %.3f | %+.1f%% |\n", ppl_before, ppl_after,
+           100.0 * (ppl_after - ppl_before) / ppl_before);
+    return 0;
+}
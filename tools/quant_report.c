@@ -0,0 +1,205 @@
+/*
+ * Integer matmul accuracy report (host build)
+ *
+ * Runs the firmware's forward() in fp32 and with the integer matmuls from
+ * src/firmware/quant.h (int8 weights, int16 or int8 activations) on a
+ * llama2.c model.bin, and prints a markdown report:
+ *   - per weight tensor: SQNR of the matmul outputs against fp32, same inputs
+ *   - end to end: logits error and top-1 agreement along the fp32 greedy
+ *     sequence, and how long a free-running greedy decode stays identical
+ *
+ * Build and run:
+ *   make quant-report
+ *   gcc -O2 -Isrc/firmware -o tools/quant_report tools/quant_report.c -lm
+ *   tools/quant_report dist/assets/model.bin [steps]
+ */
+
+#include "host_model.h"
+#include "quant.h"
+
+/* Activation widths under test */
+enum { A_INT16, A_INT8, A_COUNT };
+static const int act_max[A_COUNT] = { QUANT_ACT_MAX16, QUANT_ACT_MAX8 };
+static const char* const act_names[A_COUNT] = { "int16", "int8" };
+
+/* int8 weights of every tensor, all layers stacked as in quantize_transformer() */
+static QuantTensor wq8[T_COUNT];
+
+/* Per State (State.user) */
+typedef struct {
+    int act;            /* activation width, < 0: fp32 */
+    QuantVec xq;
+    float* scratch;     /* fp32 reference output for the per-tensor SQNR */
+} QuantRun;
+
+/* Per-tensor error accumulators: signal and noise energy per activation width */
+static double sig_energy[T_COUNT][A_COUNT];
+static double err_energy[T_COUNT][A_COUNT];
+
+/* ============================================
+ * Model
+ * ============================================ */
+
+static void quantize_model(Model* m) {
+    Config* p = &m->c;
+    long L = p->n_layers;
+    long kv_dim = (long)p->n_kv_heads * (p->dim / p->n_heads);
+    /* Layers are contiguous when nothing is pruned or factorized */
+    const float* w[T_COUNT] = { m->wq, m->wk, m->wv, m->proj[PROJ_WO].w, m->proj[PROJ_W1].w,
+                                m->proj[PROJ_W2].w, m->proj[PROJ_W3].w, m->wcls };
+    /* rows x n per tensor */
+    const long rows[T_COUNT] = { L * p->dim, L * kv_dim, L * kv_dim, L * p->dim,
+                                 L * p->hidden_dim, L * p->dim, L * p->hidden_dim, p->vocab_size };
+    const int n[T_COUNT] = { p->dim, p->dim, p->dim, p->dim, p->dim, p->hidden_dim, p->dim, p->dim };
+    for (int t = 0; t < T_COUNT; t++) {
+        wq8[t].q = xcalloc(rows[t] * quant_row_words(n[t]), sizeof(uint32_t));
+        wq8[t].s = xcalloc(rows[t], sizeof(float));
+        quantize_weights(&wq8[t], w[t], (int)rows[t], n[t]);
+    }
+}
+
+/*
+ * matmul hook: act < 0 runs fp32 and, if collecting, every activation width
+ * on the same input to accumulate the per-tensor error. act >= 0 is the
+ * integer path. Rows of layer l start at l * d in the stacked tensor.
+ */
+static int collect;
+
+static void quant_matmul(Model* m, State* s, int t, int l, float* xout, const float* x, int n, int d) {
+    QuantRun* r = s->user;
+    int row0 = l * d;
+    if (r->act >= 0) {
+        quantize_vec(&r->xq, x, n, act_max[r->act]);
+        matmul_q(xout, &r->xq, &wq8[t], row0, d);
+        return;
+    }
+    matmul_tensor(m, s, t, l, xout, x, n, d);
+    if (!collect) return;
+    for (int a = 0; a < A_COUNT; a++) {
+        quantize_vec(&r->xq, x, n, act_max[a]);
+        matmul_q(r->scratch, &r->xq, &wq8[t], row0, d);
+        for (int i = 0; i < d; i++) {
+            double e = (double)r->scratch[i] - xout[i];
+            sig_energy[t][a] += (double)xout[i] * xout[i];
+            err_energy[t][a] += e * e;
+        }
+    }
+}
+
+static void alloc_run(State* s, QuantRun* r, const Config* p) {
+    int nmax = p->dim > p->hidden_dim ? p->dim : p->hidden_dim;
+    alloc_state(s, p);
+    r->xq.q = xcalloc(quant_row_words(nmax) * 4, sizeof(int16_t));
+    r->scratch = xcalloc(p->vocab_size > nmax ? p->vocab_size : nmax, sizeof(float));
+    s->matmul = quant_matmul;
+    s->user = r;
+}
+
+static float* forward_act(Model* m, State* s, int token, int pos, int act) {
+    ((QuantRun*)s->user)->act = act;
+    return forward(m, s, token, pos);
+}
+
+/* ============================================
+ * Report
+ * ============================================ */
+
+static double sqnr_db(double sig, double err) {
+    return err > 0.0 ? 10.0 * log10(sig / err) : INFINITY;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s model.bin [steps]\n", argv[0]);
+        return 1;
+    }
+    Model m;
+    load_model(&m, argv[1]);
+    if (m.pruned || m.factorized) {
+        fprintf(stderr, "%s: pruned or factorized model not supported\n", argv[1]);
+        return 1;
+    }
+    quantize_model(&m);
+    Config* p = &m.c;
+    int steps = argc > 2 ? atoi(argv[2]) : 128;
+    if (steps > p->seq_len) steps = p->seq_len;
+    int V = p->vocab_size;
+
+    /* fp32 greedy decode from BOS: reference tokens and logits, per-tensor errors */
+    State ref;
+    QuantRun ref_run;
+    alloc_run(&ref, &ref_run, p);
+    int* tokens = xcalloc(steps + 1, sizeof(int));
+    float* ref_logits = xcalloc((long)steps * V, sizeof(float));
+    tokens[0] = 1;
+    collect = 1;
+    for (int pos = 0; pos < steps; pos++) {
+        float* logits = forward_act(&m, &ref, tokens[pos], pos, -1);
+        memcpy(ref_logits + (long)pos * V, logits, V * sizeof(float));
+        tokens[pos + 1] = argmax(logits, V);
+    }
+    collect = 0;
+
+    printf("# Integer matmul accuracy\n\n");
+    printf("`%s`: dim=%d hidden=%d layers=%d heads=%d kv_heads=%d vocab=%d, %d steps of greedy decode from BOS.\n\n",
+           argv[1], p->dim, p->hidden_dim, p->n_layers, p->n_heads, p->n_kv_heads, V, steps);
+    printf("Weights int8 with one scale per row, activations quantized once per matmul input with one scale.\n\n");
+
+    printf("## Per tensor (matmul output SQNR vs fp32, same inputs)\n\n");
+    printf("| Tensor | %s act (dB) | %s act (dB) |\n|---|---:|---:|\n", act_names[A_INT16], act_names[A_INT8]);
+    for (int t = 0; t < T_COUNT; t++) {
+        printf("| %s | %.1f | %.1f |\n", tensor_names[t],
+               sqnr_db(sig_energy[t][A_INT16], err_energy[t][A_INT16]),
+               sqnr_db(sig_energy[t][A_INT8], err_energy[t][A_INT8]));
+    }
+
+    printf("\n## End to end\n\n");
+    printf("| Metric | %s act | %s act |\n|---|---:|---:|\n", act_names[A_INT16], act_names[A_INT8]);
+    double cos_min[A_COUNT], cos_mean[A_COUNT], max_err[A_COUNT], top1[A_COUNT];
+    int greedy_match[A_COUNT];
+    State st;
+    QuantRun run;
+    alloc_run(&st, &run, p);
+    for (int a = 0; a < A_COUNT; a++) {
+        /* Teacher-forced along the fp32 sequence */
+        cos_min[a] = 1.0;
+        cos_mean[a] = 0.0;
+        max_err[a] = 0.0;
+        int agree = 0;
+        for (int pos = 0; pos < steps; pos++) {
+            float* logits = forward_act(&m, &st, tokens[pos], pos, a);
+            float* r = ref_logits + (long)pos * V;
+            double dot = 0.0, nr = 0.0, nq = 0.0;
+            for (int i = 0; i < V; i++) {
+                dot += (double)r[i] * logits[i];
+                nr += (double)r[i] * r[i];
+                nq += (double)logits[i] * logits[i];
+                double e = fabs((double)logits[i] - r[i]);
+                if (e > max_err[a]) max_err[a] = e;
+            }
+            double c = dot / (sqrt(nr * nq) + 1e-30);
+            if (c < cos_min[a]) cos_min[a] = c;
+            cos_mean[a] += c / steps;
+            agree += argmax(logits, V) == tokens[pos + 1];
+        }
+        top1[a] = 100.0 * agree / steps;
+
+        /* Free running: first position where the greedy token differs */
+        int token = 1;
+        greedy_match[a] = steps;
+        for (int pos = 0; pos < steps; pos++) {
+            token = argmax(forward_act(&m, &st, token, pos, a), V);
+            if (token != tokens[pos + 1]) {
+                greedy_match[a] = pos;
+                break;
+            }
+        }
+    }
+    printf("| Logits cosine, min | %.6f | %.6f |\n", cos_min[A_INT16], cos_min[A_INT8]);
+    printf("| Logits cosine, mean | %.6f | %.6f |\n", cos_mean[A_INT16], cos_mean[A_INT8]);
+    printf("| Logits max abs error | %.4f | %.4f |\n", max_err[A_INT16], max_err[A_INT8]);
+    printf("| Top-1 agreement (teacher forced) | %.1f%% | %.1f%% |\n", top1[A_INT16], top1[A_INT8]);
+    printf("| Greedy tokens identical to fp32 | %d/%d | %d/%d |\n",
+           greedy_match[A_INT16], steps, greedy_match[A_INT8], steps);
+    return 0;
+}
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+Vocabulary trimming for a llama2.c model.bin/tokenizer.bin pair.
+
+Story models ship with the full Llama tokenizer, but the text they are used
+for needs a fraction of it, while the vocab_size x dim embedding and wcls are
+paid in full. This keeps, in their original order:
+  - <unk>, <s>, </s>, so they stay ids 0..2 (the firmware also looks BOS and
+    EOS up by piece, see find_special_tokens())
+  - the 256 byte fallbacks <0xXX>, contiguous, so any text still encodes
+  - every piece the firmware's encode() produces for the corpus, and every
+    piece it passes through while merging
+and rewrites both files with the ids remapped: embedding rows (and wcls rows
+if unshared) are selected, vocab_size in the Config header shrinks, the rest
+of model.bin is copied, and both get a fresh CRC32 trailer. Because every
+intermediate merge is kept, the corpus encodes to the same pieces as before;
+other text may fall back to shorter pieces or bytes.
+
+Each non-empty corpus line is encoded as one text, with the dummy-prefix
+space encode() adds. Lines are split into words (a run of non-spaces with its
+leading spaces) and repeated words are cached: sentencepiece pieces never
+join a non-space to a following space, so no merge crosses that boundary.
+
+Usage:
+    python3 tools/trim_vocab.py --model dist/assets/model.bin \\
+        --tokenizer dist/assets/tokenizer.bin --corpus stories.txt --out build/trim
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import gen_model
+
+SPECIALS = 3            # <unk>, <s>, </s>
+WORD_RE = re.compile(rb' *[^ ]+| +')
+CHAR_RE = re.compile(rb'.[\x80-\xbf]{0,3}', re.S)     # as encode() groups UTF-8 bytes
+
+
+def read_tokenizer(path):
+    """(max_token_length, [(score, piece bytes)])"""
+    with open(path, 'rb') as f:
+        data = f.read()
+    max_len, = struct.unpack_from('<i', data, 0)
+    end = gen_model.tokenizer_end(data)
+    pos, tokens = 4, []
+    while pos < end:
+        score, n = struct.unpack_from('<fi', data, pos)
+        tokens.append((score, data[pos + 8:pos + 8 + n]))
+        pos += 8 + n
+    return max_len, tokens
+
+
+def write_tokenizer(path, tokens):
+    data = [struct.pack('<i', max(len(p) for _, p in tokens))]
+    for score, piece in tokens:
+        data += [struct.pack('<fi', score, len(piece)), piece]
+    data = b''.join(data)
+    with open(path, 'wb') as f:
+        f.write(data)
+        f.write(struct.pack('<2I', gen_model.CHECKSUM_MAGIC, zlib.crc32(data) & 0xFFFFFFFF))
+
+
+class Encoder:
+    """encode() from the firmware, recording every piece it touches."""
+
+    def __init__(self, tokens):
+        self.pieces = [p for _, p in tokens]
+        self.scores = [s for s, _ in tokens]
+        self.lookup = {}
+        for i, p in enumerate(self.pieces):
+            self.lookup.setdefault(p, i)
+        self.bytes = [self.lookup.get(b'<0x%02X>' % b) for b in range(256)]
+        if None in self.bytes:
+            raise ValueError('tokenizer has no byte fallback for every byte')
+        self.seen = set()
+        self.cache = {}
+
+    def word(self, word):
+        ids = self.cache.get(word)
+        if ids is not None:
+            return ids
+        ids = []
+        for ch in CHAR_RE.findall(word):
+            i = self.lookup.get(ch)
+            ids += [i] if i is not None else [self.bytes[b] for b in ch]
+        self.seen.update(ids)
+        while True:
+            best, best_i = None, -1
+            for i in range(len(ids) - 1):
+                j = self.lookup.get(self.pieces[ids[i]] + self.pieces[ids[i + 1]])
+                if j is not None and (best is None or self.scores[j] > self.scores[best]):
+                    best, best_i = j, i
+            if best is None:
+                break
+            ids[best_i:best_i + 2] = [best]
+            self.seen.add(best)
+        self.cache[word] = ids
+        return ids
+
+    def text(self, text):
+        ids = []
+        for w in WORD_RE.findall(b' ' + text):
+            ids += self.word(w)
+        return ids
+
+
+def rewrite_model(src, dst, keep):
+    """Select embedding/wcls rows; returns (config, shared, bytes before, bytes after)."""
+    c, shared = gen_model.read_config(src)
+    with open(src, 'rb') as f:
+        data = f.read()
+    header = gen_model.header_bytes(c)
+    end = gen_model.model_bytes(c, shared) - gen_model.CHECKSUM_BYTES
+    if len(data) < end:
+        raise ValueError('%s: %d bytes, Config needs %d' % (src, len(data), end))
+    row = 4 * c['dim']
+    table = c['vocab'] * row
+
+    def rows(offset):
+        return b''.join(data[offset + i * row:offset + (i + 1) * row] for i in keep)
+
+    fields = list(struct.unpack_from('<7i', data, 0))
+    fields[5] = len(keep) if shared else -len(keep)
+    out = [struct.pack('<7i', *fields), data[28:header], rows(header)]
+    if shared:
+        out.append(data[header + table:end])
+    else:
+        out += [data[header + table:end - table], rows(end - table)]
+    crc = 0
+    with open(dst, 'wb') as f:
+        for part in out:
+            crc = zlib.crc32(part, crc)
+            f.write(part)
+        f.write(struct.pack('<2I', gen_model.CHECKSUM_MAGIC, crc & 0xFFFFFFFF))
+    return c, shared, len(data), os.path.getsize(dst)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='trim a llama2.c vocabulary to the pieces a corpus uses')
+    parser.add_argument('--model', required=True)
+    parser.add_argument('--tokenizer', required=True)
+    parser.add_argument('--corpus', required=True, help='text, one story or prompt per line')
+    parser.add_argument('--out', required=True, help='output directory for model.bin and tokenizer.bin')
+    args = parser.parse_args()
+
+    _, tokens = read_tokenizer(args.tokenizer)
+    c, _ = gen_model.read_config(args.model)
+    if len(tokens) != c['vocab']:
+        parser.error('%s has %d tokens, %s has vocab_size %d' %
+                     (args.tokenizer, len(tokens), args.model, c['vocab']))
+    enc = Encoder(tokens)
+    n_tokens = 0
+    with open(args.corpus, 'rb') as f:
+        for line in f:
+            line = line.rstrip(b'\r\n')
+            if line:
+                n_tokens += len(enc.text(line))
+
+    keep = sorted(set(range(SPECIALS)) | set(enc.bytes) | enc.seen)
+    os.makedirs(args.out, exist_ok=True)
+    write_tokenizer(os.path.join(args.out, 'tokenizer.bin'), [tokens[i] for i in keep])
+    c, shared, before, after = rewrite_model(args.model, os.path.join(args.out, 'model.bin'), keep)
+
+    V, dim = c['vocab'], c['dim']
+    print('# Vocabulary trim\n')
+    print('`%s` with `%s` on `%s` (%d tokens, %d distinct pieces used or merged through).\n' %
+          (args.model, args.tokenizer, args.corpus, n_tokens, len(enc.seen)))
+    print('| | Before | After | Change |\n|---|---:|---:|---:|')
+    print('| Vocabulary | %d | %d | %.1f%% |' % (V, len(keep), 100.0 * (len(keep) - V) / V))
+    tables = 1 if shared else 2
+    print('| Embedding%s bytes | %d | %d | %.1f%% |' % ('' if shared else ' + wcls', tables * V * dim * 4,
+          tables * len(keep) * dim * 4, 100.0 * (len(keep) - V) / V))
+    print('| Classifier MACs per token | %d | %d | %.1f%% |' % (V * dim, len(keep) * dim,
+          100.0 * (len(keep) - V) / V))
+    print('| Model bytes | %d | %d | %.1f%% |' % (before, after, 100.0 * (after - before) / before))
+
+
+if __name__ == '__main__':
+    main()